@@ -70,7 +70,7 @@ void CL_RestartFilesystem(bool total);
 void CL_Activate(active_t active);
 void CL_UpdateUserinfo(cvar_t *var, from_t from);
 void CL_SendStatusRequest(const netadr_t *address);
-bool CL_GetDemoInfo(const char *path, demoInfo_t *info);
+bool CL_ParseDemoInfo(const void *data, size_t len, demoInfo_t *info);
 bool CL_CheatsOK(void);
 void CL_SetSky(void);
 
@@ -18,8 +18,6 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #pragma once
 
-#if USE_CLIENT
-
 typedef struct asyncwork_s {
     void (*work_cb)(void *);
     void (*done_cb)(void *);
@@ -27,14 +25,26 @@ typedef struct asyncwork_s {
     struct asyncwork_s *next;
 } asyncwork_t;
 
-void Com_QueueAsyncWork(asyncwork_t *work);
-void Com_CompleteAsyncWork(void);
-void Com_ShutdownAsyncWork(void);
+typedef struct jobgroup_s jobgroup_t;
 
-#else
+void Com_InitAsyncWork(void);
+void Com_ShutdownAsyncWork(void);
 
-#define Com_QueueAsyncWork(work)    (void)0
-#define Com_CompleteAsyncWork()     (void)0
-#define Com_ShutdownAsyncWork()     (void)0
+// runs work_cb on worker thread, then done_cb on main thread from
+// Com_CompleteAsyncWork
+void Com_QueueAsyncWork(asyncwork_t *work);
+void Com_CompleteAsyncWork(void);
 
-#endif
+// job groups run jobs on worker threads. jobs of a group don't start until
+// all groups it depends on are complete. dependencies must be added before
+// any jobs. group is complete when it has been closed and all its jobs are
+// done. every group must be waited for, which also frees it.
+jobgroup_t *Com_CreateJobGroup(void);
+void Com_AddJobDependency(jobgroup_t *group, jobgroup_t *dep);
+void Com_AddJob(jobgroup_t *group, void (*func)(void *), void *arg);
+void Com_CloseJobGroup(jobgroup_t *group);
+void Com_WaitJobGroup(jobgroup_t *group);
+
+// runs func(arg, index) for each index in [0, count) on worker threads
+// and the calling thread, returns when all calls are done
+void Com_ParallelFor(int count, void (*func)(void *, int), void *arg);
@@ -43,6 +43,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // FIXME: rename these
 #define COM_HISTORYFILE_NAME    ".conhistory"
 #define COM_DEMOCACHE_NAME      ".democache"
+#define COM_PACKCACHE_NAME      ".packcache"
 #define SYS_HISTORYFILE_NAME    ".syshistory"
 
 #define MAXPRINTMSG     4096
@@ -149,6 +150,8 @@ void        Sys_Printf(const char *fmt, ...) q_printf(1, 2);
 extern cvar_t   *z_perturb;
 #endif
 
+extern cvar_t   *z_profile_rate;
+
 #if USE_DEBUG
 extern cvar_t   *developer;
 #endif
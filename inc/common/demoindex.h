@@ -0,0 +1,48 @@
+/*
+Copyright (C) 2003-2006 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#pragma once
+
+#include "common/zone.h"
+
+// fake demo packet used to reconstruct state at the given demo frame
+typedef struct {
+    int         framenum;
+    unsigned    msglen;
+    int64_t     filepos;
+    byte        data[1];
+} demosnap_t;
+
+// snapshot types, bump when snapshot contents change
+#define DEMO_INDEX_DM2      1
+#define DEMO_INDEX_MVD2     2
+
+// seek index saved next to the demo file. Only covers the first
+// gamestate in the demo, since snapshots are reset on map change.
+typedef struct {
+    char        path[MAX_OSPATH];   // empty if not indexing
+    unsigned    type;
+    int64_t     demosize;
+    int64_t     mtime;
+    int         numloaded;
+    bool        loaded;
+} demoindex_t;
+
+void Demo_InitIndex(demoindex_t *index, const char *demopath, qhandle_t f, unsigned type);
+int Demo_LoadIndex(demoindex_t *index, demosnap_t ***snapshots, memtag_t tag);
+void Demo_WriteIndex(demoindex_t *index, demosnap_t **snapshots, int numsnapshots);
@@ -58,6 +58,7 @@ int FS_RenameFile(const char *from, const char *to);
 #endif
 
 int FS_CreatePath(char *path);
+void FS_FlushNegativeCache(void);
 
 int64_t FS_OpenFile(const char *filename, qhandle_t *f, unsigned mode);
 int     FS_CloseFile(qhandle_t f);
@@ -73,6 +74,25 @@ int FS_LoadFileEx(const char *path, void **buffer, unsigned flags, memtag_t tag)
 // a NULL buffer will just return the file length without loading
 // length < 0 indicates error
 
+typedef void (*fs_loadcb_t)(void *ctx, void *data, int len);
+
+typedef struct {
+    const char  *path;
+    void        *data;      // loaded data, NULL on error
+    int         len;        // file length or error
+} fs_loadreq_t;
+
+int FS_LoadFileAsync(const char *path, unsigned flags, memtag_t tag, fs_loadcb_t cb, void *ctx);
+int FS_LoadFileHeadAsync(const char *path, size_t maxlen, unsigned flags,
+                         memtag_t tag, fs_loadcb_t cb, void *ctx);
+void FS_LoadFilesAsync(fs_loadreq_t *reqs, int count, unsigned flags, memtag_t tag,
+                       void (*cb)(void *ctx, fs_loadreq_t *reqs, int count), void *ctx);
+// reads on worker threads, calls back on main thread from Com_CompleteAsyncWork
+
+int FS_MapFile(const char *path, const void **buffer);
+void FS_UnmapFile(const void *buffer);
+// read-only view, not NUL terminated, aligned to at least 4 bytes
+
 int FS_WriteFile(const char *path, const void *data, size_t len);
 
 bool FS_EasyWriteFile(char *buf, size_t size, unsigned mode,
@@ -92,6 +112,7 @@ int64_t FS_Tell(qhandle_t f);
 int FS_Seek(qhandle_t f, int64_t offset, int whence);
 
 int64_t FS_Length(qhandle_t f);
+int64_t FS_Mtime(qhandle_t f);
 
 bool FS_WildCmp(const char *filter, const char *string);
 bool FS_ExtCmp(const char *extension, const char *string);
@@ -61,6 +61,17 @@ char    *Z_TagCopyString(const char *in, memtag_t tag);
 void    Z_FreeTags(memtag_t tag);
 void    Z_LeakTest(memtag_t tag);
 void    Z_Stats_f(void);
+void    Z_Profile_f(void);
+uint64_t Z_AllocCount(void);
 
 // may return pointer to static memory
 char    *Z_CvarCopyString(const char *in);
+
+// per-thread scratch memory, released by rewinding to mark. main thread's
+// is reset every frame, worker's before every job.
+size_t  Z_FrameMark(void);
+q_malloc
+void    *Z_FrameAlloc(size_t size);
+void    Z_FrameRelease(size_t mark);
+void    Z_FrameReset(void);
+void    Z_FrameShutdown(void);
@@ -558,6 +558,17 @@ typedef struct {
     qboolean    (*EntityVisibleToClient)(edict_t *client, edict_t *ent);
 } game_q2pro_customize_entity_t;
 
+typedef struct {
+    int api_version;
+
+    // same as {Write,Read}{Game,Level}Json, but game state is passed around
+    // as an opaque binary blob; returned buffers are freed with Z_Free
+    void    *(*WriteGame)(bool autosave, size_t *size);
+    void    (*ReadGame)(const void *data, size_t size);
+    void    *(*WriteLevel)(bool transition, size_t *size);
+    void    (*ReadLevel)(const void *data, size_t size);
+} game_q2pro_binary_savegames_t;
+
 //===============================================================
 
 #define CGAME_API_VERSION   2022
@@ -34,7 +34,17 @@ void    Sys_FreeLibrary(void *handle);
 void    *Sys_GetProcAddress(void *handle, const char *sym);
 
 unsigned    Sys_Milliseconds(void);
+uint64_t    Sys_Microseconds(void);
 void        Sys_Sleep(int msec);
+int         Sys_NumCPUs(void);
+
+// positional read that doesn't move file position, safe to call
+// concurrently on the same file
+int64_t     Sys_ReadAt(FILE *fp, void *buf, size_t len, int64_t offset);
+
+// maps first `size' bytes of file read-only, returns NULL on failure
+void        *Sys_MapFile(FILE *fp, int64_t size);
+void        Sys_UnmapFile(void *base, int64_t size);
 
 void    Sys_Init(void);
 void    Sys_AddDefaultConfig(void);
@@ -86,9 +96,8 @@ bool    Sys_GetAntiCheatAPI(void);
 bool    Sys_SetNonBlock(int fd, bool nb);
 #endif
 
-#if USE_MEMORY_TRACES
 void Sys_BackTrace(void **output, size_t count, size_t offset);
-#endif
+size_t Sys_AddressName(void *addr, char *buf, size_t size);
 
 extern cvar_t   *sys_basedir;
 extern cvar_t   *sys_libdir;
@@ -29,6 +29,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "common/cmodel.h"
 #include "common/common.h"
 #include "common/cvar.h"
+#include "common/demoindex.h"
 #include "common/field.h"
 #include "common/files.h"
 #include "common/math.h"
@@ -223,6 +224,17 @@ typedef struct {
     color_t     color;
 } cl_shadow_light_t;
 
+// player state after running a single usercmd through pmove
+typedef struct {
+    pmove_state_t   s;
+    vec3_t          viewangles;
+    vec4_t          screen_blend;
+    refdef_flags_t  rdflags;
+    edict_t         *groundentity;
+    cplane_t        groundplane;
+    bool            step_clip;
+} cl_predicted_state_t;
+
 //
 // the client_state_t structure is wiped completely at every
 // server map change
@@ -239,6 +251,10 @@ typedef struct {
     usercmd_t    cmds[CMD_BACKUP];    // each message will send several old cmds
     unsigned     cmdNumber;
     vec3_t       predicted_origins[CMD_BACKUP];    // for debug comparing against server
+    cl_predicted_state_t predicted_states[CMD_BACKUP]; // pmove results indexed by cmdNumber
+    vec3_t       predicted_viewoffset;  // viewoffset predicted_states were run with
+    unsigned     predicted_last;        // last cmdNumber in predicted_states
+    bool         predicted_valid;
     client_history_t    history[CMD_BACKUP];
     unsigned    initialSeq;
 
@@ -533,13 +549,6 @@ typedef struct {
     char        path[1];
 } dlqueue_t;
 
-typedef struct {
-    int         framenum;
-    unsigned    msglen;
-    int64_t     filepos;
-    byte        data[1];
-} demosnap_t;
-
 typedef struct {
     connstate_t state;
     keydest_t   key_dest;
@@ -622,6 +631,17 @@ typedef struct {
         qhandle_t   recording;
         unsigned    time_start;
         unsigned    time_frames;
+        struct {
+            bool        active;
+            unsigned    messages;
+            unsigned    frames;
+            uint64_t    bytes;
+            uint64_t    allocs;
+            uint64_t    read_us;
+            uint64_t    parse_us;       // includes delta_us
+            uint64_t    delta_us;
+            uint64_t    lerp_us;
+        } bench;                        // demobench statistics
         int         last_server_frame;  // number of server frame the last svc_frame was written
         int         frames_written;     // number of frames written to demo file
         int         frames_dropped;     // number of svc_frames that didn't fit
@@ -634,6 +654,7 @@ typedef struct {
         sizebuf_t   buffer;
         demosnap_t  **snapshots;
         int         numsnapshots;
+        demoindex_t index;
         bool        paused;
         bool        seeking;
         bool        eof;
@@ -931,6 +952,7 @@ extern qhandle_t    gun_model;
 void V_Init(void);
 void V_Shutdown(void);
 void V_RenderView(void);
+void V_ClearScene(void);
 void V_AddEntity(const entity_t *ent);
 void V_AddParticle(const particle_t *p);
 void V_AddLightEx(cl_shadow_light_t *light);
@@ -1135,7 +1157,7 @@ void CL_EmitDemoSnapshot(void);
 void CL_FreeDemoSnapshots(void);
 void CL_FirstDemoFrame(void);
 void CL_Stop_f(void);
-bool CL_GetDemoInfo(const char *path, demoInfo_t *info);
+bool CL_ParseDemoInfo(const void *data, size_t len, demoInfo_t *info);
 
 extern q2protoio_ioarg_t demo_q2protoio_ioarg;
 #define Q2PROTO_IOARG_DEMO_WRITE    ((uintptr_t)&demo_q2protoio_ioarg)
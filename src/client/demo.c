@@ -459,7 +459,7 @@ static void CL_Record_f(void)
     char    buffer[MAX_OSPATH];
     int     i, c;
     qhandle_t       f;
-    unsigned        mode = FS_MODE_WRITE;
+    unsigned        mode = FS_MODE_WRITE | FS_FLAG_ASYNC;
     size_t          size = Cvar_ClampInteger(
                                cl_demomsglen,
                                MIN_PACKETLEN,
@@ -842,6 +842,87 @@ static int parse_next_message(int wait)
     return 0;
 }
 
+/*
+====================
+bench_demo
+
+Parses the rest of the demo (or until the next gamestate) as fast as
+possible, without rendering anything.
+====================
+*/
+static void bench_demo(void)
+{
+    uint64_t start, allocs = Z_AllocCount();
+    int ret, framenum;
+
+    while (cls.state == ca_active) {
+        start = Sys_Microseconds();
+        ret = read_next_message(cls.demo.playback);
+        cls.demo.bench.read_us += Sys_Microseconds() - start;
+        if (ret <= 0) {
+            cls.demo.bench.allocs += Z_AllocCount() - allocs;
+            finish_demo(ret);
+            return;
+        }
+
+        cls.demo.bench.messages++;
+        cls.demo.bench.bytes += msg_read.cursize;
+        framenum = cls.demo.frames_read;
+
+        start = Sys_Microseconds();
+        CL_ParseServerMessage();
+        cls.demo.bench.parse_us += Sys_Microseconds() - start;
+
+        // don't let stufftext overflow
+        Cbuf_Execute(&cl_cmdbuf);
+
+        if (cls.demo.frames_read == framenum || cls.state != ca_active)
+            continue;
+
+        // interpolate halfway between frames
+        cl.time = cl.servertime;
+        cl.lerpfrac = 0.5f;
+#if USE_FPS
+        cl.keytime = cl.keyservertime;
+        cl.keylerpfrac = 0.5f;
+#endif
+
+        start = Sys_Microseconds();
+        V_ClearScene();
+        CL_AddEntities();
+        cls.demo.bench.lerp_us += Sys_Microseconds() - start;
+        cls.demo.bench.frames++;
+    }
+
+    cls.demo.bench.allocs += Z_AllocCount() - allocs;
+}
+
+static void print_bench_stage(const char *name, uint64_t usec)
+{
+    unsigned frames = max(cls.demo.bench.frames, 1);
+
+    Com_Printf("%-6s %8.3f sec %8.2f usec/frame\n", name, usec * 1e-6, (double)usec / frames);
+}
+
+static void print_bench(void)
+{
+    uint64_t total = cls.demo.bench.read_us + cls.demo.bench.parse_us + cls.demo.bench.lerp_us;
+    double sec = max(total, 1) * 1e-6;
+    char buffer[16];
+
+    Com_FormatSizeLong(buffer, sizeof(buffer), cls.demo.bench.bytes);
+    Com_Printf("%u messages, %u frames, %s in %.3f sec\n",
+               cls.demo.bench.messages, cls.demo.bench.frames, buffer, sec);
+    Com_Printf("%.1f messages/sec, %.1f frames/sec\n",
+               cls.demo.bench.messages / sec, cls.demo.bench.frames / sec);
+    print_bench_stage("read", cls.demo.bench.read_us);
+    print_bench_stage("parse", cls.demo.bench.parse_us - cls.demo.bench.delta_us);
+    print_bench_stage("delta", cls.demo.bench.delta_us);
+    print_bench_stage("lerp", cls.demo.bench.lerp_us);
+    Com_Printf("%"PRIu64" allocations, %.2f per frame\n", cls.demo.bench.allocs,
+               (double)cls.demo.bench.allocs / max(cls.demo.bench.frames, 1));
+}
+
 /*
 ====================
 CL_PlayDemo_f
@@ -887,6 +968,7 @@ static void CL_PlayDemo_f(void)
     CL_Disconnect(ERR_RECONNECT);
 
     cls.demo.playback = f;
+    Demo_InitIndex(&cls.demo.index, name, f, DEMO_INDEX_DM2);
     cls.demo.compat = !strcmp(Cmd_Argv(2), "compat");
     cls.state = ca_connected;
     Q_strlcpy(cls.servername, COM_SkipPath(name), sizeof(cls.servername));
@@ -1123,6 +1205,15 @@ void CL_FirstDemoFrame(void)
 
     // force initial snapshot
     cls.demo.last_snapshot = INT_MIN;
+
+    // load snapshots saved by previous playback
+    if (cls.demo.file_size && cl_demosnaps->integer > 0 && !cls.demo.numsnapshots) {
+        int n = Demo_LoadIndex(&cls.demo.index, &cls.demo.snapshots, TAG_GENERAL);
+        if (n) {
+            cls.demo.numsnapshots = n;
+            cls.demo.last_snapshot = cls.demo.snapshots[n - 1]->framenum;
+        }
+    }
 }
 
 /*
@@ -1132,6 +1223,8 @@ CL_FreeDemoSnapshots
 */
 void CL_FreeDemoSnapshots(void)
 {
+    Demo_WriteIndex(&cls.demo.index, cls.demo.snapshots, cls.demo.numsnapshots);
+
     for (int i = 0; i < cls.demo.numsnapshots; i++)
         Z_Free(cls.demo.snapshots[i]);
     cls.demo.numsnapshots = 0;
@@ -1139,6 +1232,27 @@ void CL_FreeDemoSnapshots(void)
     Z_Freep(&cls.demo.snapshots);
 }
 
+/*
+====================
+CL_DemoBench_f
+====================
+*/
+static void CL_DemoBench_f(void)
+{
+    if (Cmd_Argc() < 2) {
+        Com_Printf("Usage: %s <filename>\n", Cmd_Argv(0));
+        return;
+    }
+
+    CL_PlayDemo_f();
+
+    // MVDs are passed to the server
+    if (!cls.demo.playback)
+        return;
+
+    cls.demo.bench.active = true;
+}
+
 /*
 ====================
 CL_Seek_f
@@ -1350,26 +1464,70 @@ static void parse_info_string(demoInfo_t *info, int clientNum, int index, const
     }
 }
 
+// reads next message of demo header from memory. header may be truncated,
+// which is the same as end of file.
+static int read_info_message(const byte **data, const byte *end, bool first)
+{
+    const byte *p = *data;
+    uint32_t ul, msglen;
+    uint16_t us;
+    int type;
+
+    if (end - p < 4) {
+        return Q_ERR_UNEXPECTED_EOF;
+    }
+    memcpy(&ul, p, 4);
+    p += 4;
+
+    // first message determines demo type, others return 1
+    if (first && ul == MVD_MAGIC) {
+        if (end - p < 2) {
+            return Q_ERR_UNEXPECTED_EOF;
+        }
+        memcpy(&us, p, 2);
+        p += 2;
+        if (!us) {
+            return Q_ERR_UNEXPECTED_EOF;
+        }
+        msglen = LittleShort(us);
+        type = 1;
+    } else {
+        if (ul == (uint32_t)-1) {
+            return first ? Q_ERR_UNEXPECTED_EOF : 0;
+        }
+        msglen = LittleLong(ul);
+        type = !first;
+    }
+
+    if (msglen > MAX_MSGLEN) {
+        return Q_ERR_INVALID_FORMAT;
+    }
+    if (end - p < msglen) {
+        return Q_ERR_UNEXPECTED_EOF;
+    }
+
+    SZ_InitRead(&msg_read, p, msglen);
+    *data = p + msglen;
+    return type;
+}
+
 /*
 ====================
-CL_GetDemoInfo
+CL_ParseDemoInfo
+
+Parses map and POV names from the leading bytes of a demo.
 ====================
 */
-bool CL_GetDemoInfo(const char *path, demoInfo_t *info)
+bool CL_ParseDemoInfo(const void *data, size_t len, demoInfo_t *info)
 {
-    qhandle_t f;
+    const byte *p = data, *end = p + len;
     int c, index, clientNum, flags, type;
     const cs_remap_t *csr = &cs_remap_old;
     bool res = false;
 
-    FS_OpenFile(path, &f, FS_MODE_READ | FS_FLAG_GZIP);
-    if (!f) {
-        return false;
-    }
-
     nonfatal_client_read_errors = true;
 
-    type = read_first_message(f);
+    type = read_info_message(&p, end, true);
     if (type < 0) {
         goto fail;
     }
@@ -1404,7 +1562,7 @@ bool CL_GetDemoInfo(const char *path, demoInfo_t *info)
         while (1) {
             q2proto_error_t err = q2proto_client_read(&demo_context, Q2PROTO_IOARG_CLIENT_READ, &message);
             if (err == Q2P_ERR_NO_MORE_INPUT) {
-                if (read_next_message(f) <= 0) {
+                if (read_info_message(&p, end, false) <= 0) {
                     break;
                 }
                 continue; // parse new message
@@ -1460,7 +1618,7 @@ bool CL_GetDemoInfo(const char *path, demoInfo_t *info)
     res = true;
 
 fail:
-    FS_CloseFile(f);
+    SZ_Clear(&msg_read);
     nonfatal_client_read_errors = false;
     return res;
 }
@@ -1476,7 +1634,9 @@ void CL_CleanupDemos(void)
     if (cls.demo.playback) {
         FS_CloseFile(cls.demo.playback);
 
-        if (com_timedemo->integer && cls.demo.time_frames) {
+        if (cls.demo.bench.active) {
+            print_bench();
+        } else if (com_timedemo->integer && cls.demo.time_frames) {
             unsigned msec = Sys_Milliseconds();
 
             if (msec > cls.demo.time_start) {
@@ -1514,6 +1674,11 @@ void CL_DemoFrame(void)
         return;
     }
 
+    if (cls.demo.bench.active) {
+        bench_demo();
+        return;
+    }
+
     if (com_timedemo->integer) {
         parse_next_message(0);
         cl.time = cl.servertime;
@@ -1540,6 +1705,7 @@ void CL_DemoFrame(void)
 
 static const cmdreg_t c_demo[] = {
     { "demo", CL_PlayDemo_f, CL_Demo_c },
+    { "demobench", CL_DemoBench_f, CL_Demo_c },
     { "record", CL_Record_f, CL_Demo_c },
     { "stop", CL_Stop_f },
     { "suspend", CL_Suspend_f },
@@ -323,6 +323,7 @@ static void set_active_state(void)
 
     cl.last_groundentity = NULL;
     memset(&cl.last_groundplane, 0, sizeof(cl.last_groundplane));
+    cl.predicted_valid = false;
 
     SCR_EndLoadingPlaque();     // get rid of loading plaque
     SCR_LagClear();
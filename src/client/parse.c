@@ -473,8 +473,17 @@ static void CL_ParseFrame(const q2proto_svc_frame_t *frame_msg)
 
     cls.demo.frames_read++;
 
-    if (!cls.demo.seeking)
+    if (cls.demo.seeking)
+        return;
+
+    if (cls.demo.bench.active) {
+        uint64_t start = Sys_Microseconds();
         CL_DeltaFrame();
+        cls.demo.bench.delta_us += Sys_Microseconds() - start;
+        return;
+    }
+
+    CL_DeltaFrame();
 }
 
 /*
@@ -217,6 +217,69 @@ void CL_PredictAngles(void)
 
 #define	MAX_STEP_CHANGE 32
 
+static void CL_SavePredictedState(const pmove_t *pm, unsigned number)
+{
+    cl_predicted_state_t *state = &cl.predicted_states[number & CMD_MASK];
+
+    state->s = pm->s;
+    VectorCopy(pm->viewangles, state->viewangles);
+    Vector4Copy(pm->screen_blend, state->screen_blend);
+    state->rdflags = pm->rdflags;
+    state->groundentity = pm->groundentity;
+    state->groundplane = pm->groundplane;
+    state->step_clip = pm->step_clip;
+}
+
+static void CL_LoadPredictedState(pmove_t *pm, unsigned number)
+{
+    const cl_predicted_state_t *state = &cl.predicted_states[number & CMD_MASK];
+
+    pm->s = state->s;
+    VectorCopy(state->viewangles, pm->viewangles);
+    Vector4Copy(state->screen_blend, pm->screen_blend);
+    pm->rdflags = state->rdflags;
+    pm->groundentity = state->groundentity;
+    pm->groundplane = state->groundplane;
+    pm->step_clip = state->step_clip;
+}
+
+static bool CL_PmoveStatesEqual(const pmove_state_t *a, const pmove_state_t *b)
+{
+    return a->pm_type == b->pm_type
+        && VectorCompare(a->origin, b->origin)
+        && VectorCompare(a->velocity, b->velocity)
+        && a->pm_flags == b->pm_flags
+        && a->pm_time == b->pm_time
+        && a->gravity == b->gravity
+        && VectorCompare(a->delta_angles, b->delta_angles)
+        && a->viewheight == b->viewheight;
+}
+
+/*
+=================
+CL_CanExtendPrediction
+
+Predicted states are cached per usercmd. If the state server returned for
+the last acknowledged usercmd matches what we had predicted for it, then
+every cached state after it is still valid and only new usercmds need to
+be run through pmove.
+=================
+*/
+static bool CL_CanExtendPrediction(unsigned ack)
+{
+    if (!cl.predicted_valid)
+        return false;
+
+    // acknowledged usercmd must have been predicted
+    if (cl.predicted_last - ack >= CMD_BACKUP)
+        return false;
+
+    if (!VectorCompare(cl.predicted_viewoffset, cl.frame.ps.viewoffset))
+        return false;
+
+    return CL_PmoveStatesEqual(&cl.predicted_states[ack & CMD_MASK].s, &cl.frame.ps.pmove);
+}
+
 void CL_PredictMovement(void)
 {
     unsigned    ack, current, frame;
@@ -238,6 +301,7 @@ void CL_PredictMovement(void)
     if (!cl_predict->integer || (cl.frame.ps.pmove.pm_flags & PMF_NO_PREDICTION)) {
         // just set angles
         CL_PredictAngles();
+        cl.predicted_valid = false;
         return;
     }
 
@@ -247,6 +311,7 @@ void CL_PredictMovement(void)
     // if we are too far out of date, just freeze
     if (current - ack > CMD_BACKUP - 1) {
         SHOWMISS("%i: exceeded CMD_BACKUP\n", cl.frame.number);
+        cl.predicted_valid = false;
         return;
     }
 
@@ -260,20 +325,35 @@ void CL_PredictMovement(void)
     pm.trace = CL_PMTrace;
     pm.clip = CL_Clip;
     pm.pointcontents = CL_PointContents;
-    pm.s = cl.frame.ps.pmove;
     VectorCopy(cl.frame.ps.viewoffset, pm.viewoffset);
-    pm.snapinitial = qtrue;
 
-    // run framesgit 
+    if (CL_CanExtendPrediction(ack)) {
+        // continue from the last cached state
+        ack = cl.predicted_last;
+        CL_LoadPredictedState(&pm, ack);
+    } else {
+        // replay everything since the last acknowledged usercmd
+        pm.s = cl.frame.ps.pmove;
+        pm.snapinitial = qtrue;
+        CL_SavePredictedState(&pm, ack);
+        VectorCopy(cl.frame.ps.viewoffset, cl.predicted_viewoffset);
+        cl.predicted_valid = true;
+    }
+
+    // run frames
     while (++ack <= current) {
         pm.cmd = cl.cmds[ack & CMD_MASK];
         cgame->Pmove(&pm);
         pm.snapinitial = qfalse;
 
+        CL_SavePredictedState(&pm, ack);
+
         // save for debug checking
         VectorCopy(pm.s.origin, cl.predicted_origins[ack & CMD_MASK]);
     }
 
+    cl.predicted_last = current;
+
     // run pending cmd
     if (cl.cmd.msec) {
         pm.cmd = cl.cmd;
@@ -956,7 +956,7 @@ static channel_t *AL_FindLoopingSound(int entnum, const sfx_t *sfx)
 static void AL_MergeLoopSounds(void)
 {
     int         i, j;
-    int         sounds[MAX_EDICTS];
+    int         *sounds;
     float       left, right, left_total, right_total, vol, att;
     float       pan, pan2, gain;
     channel_t   *ch;
@@ -965,9 +965,15 @@ static void AL_MergeLoopSounds(void)
     int         num;
     entity_state_t *ent;
     vec3_t      origin;
+    size_t      mark;
 
-    if (!S_BuildSoundList(sounds))
+    mark = Z_FrameMark();
+    sounds = Z_FrameAlloc(sizeof(sounds[0]) * cl.frame.numEntities);
+
+    if (!S_BuildSoundList(sounds)) {
+        Z_FrameRelease(mark);
         return;
+    }
 
     for (i = 0; i < cl.frame.numEntities; i++) {
         if (!sounds[i])
@@ -1060,21 +1066,26 @@ static void AL_MergeLoopSounds(void)
             AL_StopChannel(ch);
         }
     }
+
+    Z_FrameRelease(mark);
 }
 
 static void AL_AddLoopSounds(void)
 {
     int         i;
-    int         sounds[MAX_EDICTS];
+    int         *sounds;
     channel_t   *ch;
     sfx_t       *sfx;
     sfxcache_t  *sc;
     int         num;
     entity_state_t *ent;
+    size_t      mark;
 
     if (cls.state != ca_active || sv_paused->integer || !s_ambient->integer)
         return;
 
+    mark = Z_FrameMark();
+    sounds = Z_FrameAlloc(sizeof(sounds[0]) * cl.frame.numEntities);
     S_BuildSoundList(sounds);
 
     for (i = 0; i < cl.frame.numEntities; i++) {
@@ -1113,6 +1124,8 @@ static void AL_AddLoopSounds(void)
 
         AL_PlayChannel(ch);
     }
+
+    Z_FrameRelease(mark);
 }
 
 #define MAX_STREAM_BUFFERS  32
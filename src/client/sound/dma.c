@@ -82,7 +82,7 @@ static sfxcache_t *DMA_UploadSfx(sfx_t *sfx)
     else if (sc->width == 2 && sc->channels == 2)
         RESAMPLE memcpy(sc->data + i * 4, s_info.data + j * 4, 4);
     else
-        RESAMPLE ((uint16_t *)sc->data)[i] = ((uint16_t *)s_info.data)[j];
+        RESAMPLE memcpy(sc->data + i * 2, s_info.data + j * 2, 2);
 
     return sc;
 }
@@ -693,7 +693,7 @@ as the entities are sent to the client
 static void AddLoopSounds(void)
 {
     int         i, j;
-    int         sounds[MAX_EDICTS];
+    int         *sounds;
     float       left, right, left_total, right_total, vol, att;
     channel_t   *ch;
     sfx_t       *sfx;
@@ -701,9 +701,15 @@ static void AddLoopSounds(void)
     int         num;
     entity_state_t *ent;
     vec3_t      origin;
+    size_t      mark;
 
-    if (!S_BuildSoundList(sounds))
+    mark = Z_FrameMark();
+    sounds = Z_FrameAlloc(sizeof(sounds[0]) * cl.frame.numEntities);
+
+    if (!S_BuildSoundList(sounds)) {
+        Z_FrameRelease(mark);
         return;
+    }
 
     for (i = 0; i < cl.frame.numEntities; i++) {
         if (!sounds[i])
@@ -749,7 +755,7 @@ static void AddLoopSounds(void)
         // allocate a channel
         ch = S_PickChannel(0, 0);
         if (!ch)
-            return;
+            break;
 
         ch->leftvol = min(left_total, 1.0f);
         ch->rightvol = min(right_total, 1.0f);
@@ -760,6 +766,8 @@ static void AddLoopSounds(void)
         ch->pos = s_paintedtime % sc->length;
         ch->end = s_paintedtime + sc->length - ch->pos;
     }
+
+    Z_FrameRelease(mark);
 }
 
 static int DMA_GetTime(void)
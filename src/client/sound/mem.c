@@ -443,25 +443,34 @@ static bool GetWavinfo(sizebuf_t *sz)
     return true;
 }
 
-static void ConvertSamples(void)
+// samples point into read-only file view, so convert into temporary
+// buffer. returns true if it needs to be freed.
+static bool ConvertSamples(void)
 {
-    uint16_t *data = (uint16_t *)s_info.data;
     int count = s_info.samples * s_info.channels;
+    uint16_t *data;
 
 // sigh. truncate 24 bit to 16
     if (s_info.width == 3) {
+        data = FS_AllocTempMem(count * sizeof(data[0]));
         for (int i = 0; i < count; i++)
-            data[i] = RL32(&s_info.data[i * 3]) >> 8;
+            data[i] = RL16(&s_info.data[i * 3 + 1]);
+        s_info.data = (byte *)data;
         s_info.width = 2;
-        return;
+        return true;
     }
 
 #if USE_BIG_ENDIAN
     if (s_info.width == 2) {
+        data = FS_AllocTempMem(count * sizeof(data[0]));
         for (int i = 0; i < count; i++)
-            data[i] = LittleShort(data[i]);
+            data[i] = RL16(&s_info.data[i * 2]);
+        s_info.data = (byte *)data;
+        return true;
     }
 #endif
+
+    return false;
 }
 
 // ===============================================================================
@@ -474,10 +483,11 @@ S_LoadSound
 sfxcache_t *S_LoadSound(sfx_t *s)
 {
     sizebuf_t   sz;
-    byte        *data;
+    const byte  *data;
     sfxcache_t  *sc;
     int         len;
     char        *name;
+    bool        converted = false;
 
     if (s->name[0] == '*')
         return NULL;
@@ -497,7 +507,7 @@ sfxcache_t *S_LoadSound(sfx_t *s)
     else
         name = s->name;
 
-    len = FS_LoadFile(name, (void **)&data);
+    len = FS_MapFile(name, (const void **)&data);
     if (!data) {
         if (len != Q_ERR(ENOENT))
             Com_EPrintf("Couldn't load %s: %s\n", Com_MakePrintable(name), Q_ErrorString(len));
@@ -516,10 +526,13 @@ sfxcache_t *S_LoadSound(sfx_t *s)
     }
 
     if (s_info.format == FORMAT_PCM)
-        ConvertSamples();
+        converted = ConvertSamples();
 
     sc = s_api->upload_sfx(s);
 
+    if (converted)
+        FS_FreeTempMem(s_info.data);
+
 #if USE_AVCODEC
     if (s_info.format != FORMAT_PCM)
         FS_FreeTempMem(s_info.data);
@@ -528,6 +541,6 @@ sfxcache_t *S_LoadSound(sfx_t *s)
 fail:
     if (!sc)
         Com_EPrintf("Couldn't load %s: %s\n", Com_MakePrintable(name), Com_GetLastError());
-    FS_FreeFile(data);
+    FS_UnmapFile(data);
     return sc;
 }
@@ -17,8 +17,8 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 */
 
 #include "ui.h"
+#include "common/async.h"
 #include "common/files.h"
-#include "common/mdfour.h"
 
 /*
 =======================================================================
@@ -35,6 +35,10 @@ DEMOS MENU
 #define DEMO_MVD_POV    "\x90\xcd\xd6\xc4\x91" // [MVD]
 #define DEMO_DIR_SIZE   "\x90\xc4\xc9\xd2\x91" // [DIR]
 
+#define DEMO_CACHE_HASH 1024
+#define DEMO_SCAN_JOBS  16          // max header reads in flight
+#define DEMO_SCAN_SIZE  0x40000     // enough for serverdata and configstrings
+
 #define ENTRY_UP    1
 #define ENTRY_DN    2
 #define ENTRY_DEMO  3
@@ -46,8 +50,20 @@ DEMOS MENU
 #define COL_POV     4
 #define COL_MAX     5
 
+typedef struct demoCache_s {
+    struct demoCache_s  *next;
+    unsigned    seq;        // last listing this was seen in
+    int64_t     size;
+    time_t      mtime;
+    char        map[MAX_QPATH];
+    char        pov[MAX_CLIENT_NAME];
+    char        path[1];
+} demoCache_t;
+
 typedef struct {
     unsigned    type;
+    bool        pending;
+    bool        scanning;
     int64_t     size;
     time_t      mtime;
     char        name[1];
@@ -57,7 +73,10 @@ typedef struct {
     menuFrameWork_t menu;
     menuList_t      list;
     int             numDirs;
-    uint8_t         hash[16];
+    int             numPending;
+    int             numScanning;
+    int             scanPos;
+    unsigned        generation;
     char            browse[MAX_OSPATH];
     int             selection;
     int             year;
@@ -68,47 +87,241 @@ typedef struct {
 
 static m_demos_t    m_demos;
 
+// demo info cache shared by all directories, keyed by path, size and mtime
+static demoCache_t  *demo_cache[DEMO_CACHE_HASH];
+static bool         demo_cache_loaded;
+static bool         demo_cache_dirty;
+static unsigned     demo_cache_seq;
+static int          demo_scans;     // header reads in flight
+
+// header read of uncached demo, entry is only valid if list generation
+// still matches
+typedef struct {
+    unsigned    generation;
+    int         index;      // hint, list can be resorted meanwhile
+    demoEntry_t *entry;
+    int64_t     size;
+    time_t      mtime;
+    char        path[1];
+} demoScan_t;
+
 static cvar_t       *ui_sortdemos;
 static cvar_t       *ui_listalldemos;
 
-static void BuildName(const file_info_t *info, char **cache)
+static demoCache_t *FindCache(const char *path, int64_t size, time_t mtime)
 {
-    char buffer[MAX_OSPATH];
-    char date[MAX_QPATH];
-    demoInfo_t demo;
-    demoEntry_t *e;
-    struct tm *tm;
+    unsigned hash = Com_HashString(path, DEMO_CACHE_HASH);
+    demoCache_t *c;
+
+    for (c = demo_cache[hash]; c; c = c->next) {
+        if (!strcmp(c->path, path)) {
+            c->seq = demo_cache_seq;
+            if (c->size == size && c->mtime == mtime) {
+                return c;
+            }
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void AddCache(const char *path, int64_t size, time_t mtime, const demoInfo_t *demo)
+{
+    unsigned hash = Com_HashString(path, DEMO_CACHE_HASH);
+    demoCache_t *c;
     size_t len;
 
-    memset(&demo, 0, sizeof(demo));
-    strcpy(demo.map, "???");
-    strcpy(demo.pov, "???");
+    // these would break cache file syntax, map and pov are escaped
+    if (strpbrk(path, "\\\n")) {
+        return;
+    }
 
-    if (cache) {
-        char *s = *cache;
-        char *p = strchr(s, '\\');
-        if (p) {
-            *p = 0;
-            Q_strlcpy(demo.map, s, sizeof(demo.map));
-            s = p + 1;
-            p = strchr(s, '\\');
-            if (p) {
-                *p = 0;
-                Q_strlcpy(demo.pov, s, sizeof(demo.pov));
-                s = p + 1;
+    for (c = demo_cache[hash]; c; c = c->next) {
+        if (!strcmp(c->path, path)) {
+            break;
+        }
+    }
+
+    if (!c) {
+        len = strlen(path);
+        c = UI_Malloc(sizeof(*c) + len);
+        memcpy(c->path, path, len + 1);
+        c->next = demo_cache[hash];
+        demo_cache[hash] = c;
+    }
+
+    c->seq = demo_cache_seq;
+    c->size = size;
+    c->mtime = mtime;
+    Q_strlcpy(c->map, demo->map, sizeof(c->map));
+    Q_strlcpy(c->pov, demo->pov, sizeof(c->pov));
+
+    demo_cache_dirty = true;
+}
+
+// removes cached demos of listed directory that weren't found in it
+static void PruneCache(const char *dir)
+{
+    size_t len = strlen(dir);
+    demoCache_t *c, **back;
+    int i;
+
+    for (i = 0; i < DEMO_CACHE_HASH; i++) {
+        back = &demo_cache[i];
+        while ((c = *back) != NULL) {
+            if (c->seq != demo_cache_seq && !strncmp(c->path, dir, len)
+                && c->path[len] == '/' && !strchr(c->path + len + 1, '/')) {
+                *back = c->next;
+                Z_Free(c);
+                demo_cache_dirty = true;
+            } else {
+                back = &c->next;
             }
         }
-        *cache = s;
-    } else {
-        Q_concat(buffer, sizeof(buffer), m_demos.browse, "/", info->name);
-        CL_GetDemoInfo(buffer, &demo);
-        if (demo.mvd) {
-            strcpy(demo.pov, DEMO_MVD_POV);
+    }
+}
+
+// map and pov come from demo files and may contain anything
+static char *EscapeField(char *buf, size_t size, const char *s)
+{
+    char *p = buf;
+
+    for (; *s && p < buf + size - 3; s++) {
+        if (*s == '%' || *s == '\\' || *s == '\n' || *s == '\r') {
+            p += Q_snprintf(p, 4, "%%%02x", (byte)*s);
+        } else {
+            *p++ = *s;
         }
     }
+    *p = 0;
 
-    // resize columns
-    len = strlen(demo.map);
+    return buf;
+}
+
+static void UnescapeField(char *s)
+{
+    char *p = s;
+    int c1, c2;
+
+    while (*s) {
+        if (*s == '%' && (c1 = Q_charhex(s[1])) != -1 && (c2 = Q_charhex(s[2])) != -1) {
+            *p++ = (c1 << 4) | c2;
+            s += 3;
+        } else {
+            *p++ = *s++;
+        }
+    }
+    *p = 0;
+}
+
+static void LoadCache(void)
+{
+    char *cache, *p, *next, *path, *map, *pov;
+    demoInfo_t demo;
+    int64_t size, mtime;
+
+    if (demo_cache_loaded) {
+        return;
+    }
+    demo_cache_loaded = true;
+
+    FS_LoadFileEx(COM_DEMOCACHE_NAME, (void **)&cache, FS_TYPE_REAL | FS_PATH_GAME | FS_DIR_HOME, TAG_FILESYSTEM);
+    if (!cache) {
+        return;
+    }
+
+    // each line is "size mtime path\map\pov" with map and pov escaped,
+    // skip anything malformed
+    for (p = cache; *p; p = next) {
+        next = strchr(p, '\n');
+        if (next) {
+            *next++ = 0;
+        } else {
+            next = p + strlen(p);
+        }
+
+        size = strtoll(p, &p, 10);
+        if (*p != ' ') {
+            continue;
+        }
+        mtime = strtoll(p + 1, &p, 10);
+        if (*p != ' ') {
+            continue;
+        }
+        path = p + 1;
+        map = strchr(path, '\\');
+        if (!map) {
+            continue;
+        }
+        *map++ = 0;
+        pov = strchr(map, '\\');
+        if (!pov) {
+            continue;
+        }
+        *pov++ = 0;
+
+        UnescapeField(map);
+        UnescapeField(pov);
+        Q_strlcpy(demo.map, map, sizeof(demo.map));
+        Q_strlcpy(demo.pov, pov, sizeof(demo.pov));
+        AddCache(path, size, mtime, &demo);
+    }
+
+    FS_FreeFile(cache);
+    demo_cache_dirty = false;
+}
+
+static void WriteCache(void)
+{
+    char map[MAX_QPATH * 3], pov[MAX_CLIENT_NAME * 3];
+    demoCache_t *c;
+    qhandle_t f;
+    int i;
+
+    if (!demo_cache_dirty) {
+        return;
+    }
+    demo_cache_dirty = false;
+
+    FS_OpenFile(COM_DEMOCACHE_NAME, &f, FS_MODE_WRITE);
+    if (!f) {
+        return;
+    }
+
+    for (i = 0; i < DEMO_CACHE_HASH; i++) {
+        for (c = demo_cache[i]; c; c = c->next) {
+            FS_FPrintf(f, "%"PRId64" %"PRId64" %s\\%s\\%s\n",
+                       c->size, (int64_t)c->mtime, c->path,
+                       EscapeField(map, sizeof(map), c->map),
+                       EscapeField(pov, sizeof(pov), c->pov));
+        }
+    }
+    FS_CloseFile(f);
+}
+
+static void FreeCache(void)
+{
+    demoCache_t *c, *next;
+    int i;
+
+    for (i = 0; i < DEMO_CACHE_HASH; i++) {
+        for (c = demo_cache[i]; c; c = next) {
+            next = c->next;
+            Z_Free(c);
+        }
+        demo_cache[i] = NULL;
+    }
+
+    demo_cache_loaded = false;
+    demo_cache_dirty = false;
+}
+
+static void ResizeColumns(const demoInfo_t *demo)
+{
+    size_t len;
+
+    len = strlen(demo->map);
     if (len > 8) {
         len = 8;
     }
@@ -116,10 +329,35 @@ static void BuildName(const file_info_t *info, char **cache)
         m_demos.widest_map = len;
     }
 
-    len = strlen(demo.pov);
+    len = strlen(demo->pov);
     if (len > m_demos.widest_pov) {
         m_demos.widest_pov = len;
     }
+}
+
+static void BuildName(const file_info_t *info)
+{
+    char buffer[MAX_OSPATH];
+    char date[MAX_QPATH];
+    demoInfo_t demo;
+    demoCache_t *c;
+    demoEntry_t *e;
+    struct tm *tm;
+    size_t len;
+
+    // headers of uncached demos are read later, a few per frame
+    Q_concat(buffer, sizeof(buffer), m_demos.browse, "/", info->name);
+    c = FindCache(buffer, info->size, info->mtime);
+    if (c) {
+        Q_strlcpy(demo.map, c->map, sizeof(demo.map));
+        Q_strlcpy(demo.pov, c->pov, sizeof(demo.pov));
+    } else {
+        strcpy(demo.map, "...");
+        strcpy(demo.pov, "...");
+    }
+
+    // resize columns
+    ResizeColumns(&demo);
 
     // format date
     len = 0;
@@ -139,151 +377,206 @@ static void BuildName(const file_info_t *info, char **cache)
     e = UI_FormatColumns(DEMO_EXTRASIZE,
                          info->name, date, buffer, demo.map, demo.pov, NULL);
     e->type = ENTRY_DEMO;
+    e->pending = !c;
+    e->scanning = false;
     e->size = info->size;
     e->mtime = info->mtime;
 
+    m_demos.numPending += e->pending;
     m_demos.total_bytes += info->size;
 
     m_demos.list.items[m_demos.list.numItems++] = e;
 }
 
+static void UpdateName(int index, const demoInfo_t *demo)
+{
+    demoEntry_t *e = m_demos.list.items[index];
+    demoEntry_t *n;
+
+    ResizeColumns(demo);
+
+    n = UI_FormatColumns(DEMO_EXTRASIZE, e->name,
+                         UI_GetColumn(e->name, COL_DATE),
+                         UI_GetColumn(e->name, COL_SIZE),
+                         demo->map, demo->pov, NULL);
+    n->type = e->type;
+    n->pending = false;
+    n->scanning = false;
+    n->size = e->size;
+    n->mtime = e->mtime;
+
+    m_demos.list.items[index] = n;
+    m_demos.numPending--;
+    Z_Free(e);
+}
+
 static void BuildDir(const char *name, int type)
 {
     demoEntry_t *e = UI_FormatColumns(DEMO_EXTRASIZE, name, "-", DEMO_DIR_SIZE, "-", "-", NULL);
 
     e->type = type;
+    e->pending = false;
+    e->scanning = false;
     e->size = 0;
     e->mtime = 0;
 
     m_demos.list.items[m_demos.list.numItems++] = e;
 }
 
-static char *LoadCache(void)
+static menuSound_t Change(menuCommon_t *self)
 {
-    char buffer[MAX_OSPATH], *cache;
-    int i, len;
-    uint8_t hash[16];
+    demoEntry_t *e;
 
-    if (Q_concat(buffer, sizeof(buffer), m_demos.browse, "/" COM_DEMOCACHE_NAME) >= sizeof(buffer)) {
-        return NULL;
-    }
-    len = FS_LoadFileEx(buffer, (void **)&cache, FS_TYPE_REAL | FS_PATH_GAME | FS_DIR_HOME, TAG_FILESYSTEM);
-    if (!cache) {
-        return NULL;
-    }
-    if (len < 33) {
-        goto fail;
+    if (!m_demos.list.numItems) {
+        m_demos.menu.status = "No demos found";
+        return QMS_BEEP;
     }
 
-    for (i = 0; i < 16; i++) {
-        int c1 = Q_charhex(cache[i * 2 + 0]);
-        int c2 = Q_charhex(cache[i * 2 + 1]);
-        if (c1 == -1 || c2 == -1) {
-            goto fail;
-        }
-        hash[i] = (c1 << 4) | c2;
+    e = m_demos.list.items[m_demos.list.curvalue];
+    switch (e->type) {
+    case ENTRY_DEMO:
+        m_demos.menu.status = "Press Enter to play demo";
+        break;
+    default:
+        m_demos.menu.status = "Press Enter to change directory";
+        break;
     }
 
-    if (cache[32] != '\\') {
-        goto fail;
-    }
+    return QMS_SILENT;
+}
 
-    if (memcmp(hash, m_demos.hash, 16)) {
-        goto fail;
-    }
+static void UpdateStatus(void)
+{
+    int i = m_demos.list.numItems - m_demos.numDirs;
+    size_t len;
 
-    Com_DPrintf("%s: loading from cache\n", __func__);
-    return cache;
+    if (m_demos.numPending) {
+        Q_snprintf(m_demos.status, sizeof(m_demos.status),
+                   "Scanning %d demo%s...", m_demos.numPending,
+                   m_demos.numPending == 1 ? "" : "s");
+        return;
+    }
 
-fail:
-    FS_FreeFile(cache);
-    return NULL;
+    len = Q_scnprintf(m_demos.status, sizeof(m_demos.status),
+                      "%d demo%s, ", i, i == 1 ? "" : "s");
+    Com_FormatSizeLong(m_demos.status + len, sizeof(m_demos.status) - len,
+                       m_demos.total_bytes);
 }
 
-static void WriteCache(void)
+// called on main thread when header read is done. header is parsed here,
+// CL_ParseDemoInfo is not thread safe.
+static void ScanDone(void *ctx, void *data, int len)
 {
-    char buffer[MAX_OSPATH];
-    qhandle_t f;
+    demoScan_t *scan = ctx;
+    demoInfo_t demo;
     int i;
-    char *map, *pov;
-    demoEntry_t *e;
 
-    if (m_demos.list.numItems == m_demos.numDirs) {
-        return;
+    memset(&demo, 0, sizeof(demo));
+    strcpy(demo.map, "???");
+    strcpy(demo.pov, "???");
+
+    if (data) {
+        CL_ParseDemoInfo(data, len, &demo);
+        FS_FreeFile(data);
     }
-    if (Q_concat(buffer, sizeof(buffer), m_demos.browse, "/" COM_DEMOCACHE_NAME) >= sizeof(buffer)) {
-        return;
+    if (demo.mvd) {
+        strcpy(demo.pov, DEMO_MVD_POV);
     }
-    FS_OpenFile(buffer, &f, FS_MODE_WRITE);
-    if (!f) {
+
+    AddCache(scan->path, scan->size, scan->mtime, &demo);
+    demo_scans--;
+
+    if (scan->generation != m_demos.generation) {
+        Z_Free(scan);
         return;
     }
 
-    for (i = 0; i < 16; i++) {
-        FS_FPrintf(f, "%02x", m_demos.hash[i]);
+    i = scan->index;
+    if (i >= m_demos.list.numItems || m_demos.list.items[i] != scan->entry) {
+        for (i = m_demos.numDirs; i < m_demos.list.numItems; i++) {
+            if (m_demos.list.items[i] == scan->entry) {
+                break;
+            }
+        }
     }
-    FS_FPrintf(f, "\\");
+    Z_Free(scan);
 
-    for (i = m_demos.numDirs; i < m_demos.list.numItems; i++) {
-        e = m_demos.list.items[i];
-        map = UI_GetColumn(e->name, COL_MAP);
-        pov = UI_GetColumn(e->name, COL_POV);
-        FS_FPrintf(f, "%s\\%s\\", map, pov);
+    m_demos.numScanning--;
+    if (i == m_demos.list.numItems) {
+        return;
     }
-    FS_CloseFile(f);
+    UpdateName(i, &demo);
+
+    if (!m_demos.numPending) {
+        // map and pov columns are final now
+        if (m_demos.list.sortdir && m_demos.list.sortcol >= COL_MAP) {
+            m_demos.list.sort(&m_demos.list);
+        }
+        WriteCache();
+    }
+
+    // resize columns
+    m_demos.menu.size(&m_demos.menu);
+
+    UpdateStatus();
 }
 
-static void CalcHash(void **list)
+static void ScanName(int index)
 {
-    struct mdfour md;
-    file_info_t *info;
+    demoEntry_t *e = m_demos.list.items[index];
+    demoScan_t *scan;
     size_t len;
-
-    mdfour_begin(&md);
-    while (*list) {
-        info = *list++;
-        len = sizeof(*info) + strlen(info->name) - 1;
-        mdfour_update(&md, (uint8_t *)info, len);
+    int ret;
+
+    len = strlen(m_demos.browse) + 1 + strlen(e->name);
+    scan = UI_Malloc(sizeof(*scan) + len);
+    Q_concat(scan->path, len + 1, m_demos.browse, "/", e->name);
+    scan->generation = m_demos.generation;
+    scan->index = index;
+    scan->entry = e;
+    scan->size = e->size;
+    scan->mtime = e->mtime;
+
+    e->scanning = true;
+    m_demos.numScanning++;
+    demo_scans++;
+
+    // may call back before returning
+    ret = FS_LoadFileHeadAsync(scan->path, DEMO_SCAN_SIZE, FS_FLAG_GZIP,
+                               TAG_FILESYSTEM, ScanDone, scan);
+    if (ret < 0) {
+        ScanDone(scan, NULL, ret);
     }
-    mdfour_result(&md, m_demos.hash);
 }
 
-static menuSound_t Change(menuCommon_t *self)
+// queues header reads of uncached demos, a few at a time. list can be
+// resorted meanwhile, so just keep wrapping around.
+static void ScanPending(void)
 {
     demoEntry_t *e;
 
-    if (!m_demos.list.numItems) {
-        m_demos.menu.status = "No demos found";
-        return QMS_BEEP;
-    }
-
-    e = m_demos.list.items[m_demos.list.curvalue];
-    switch (e->type) {
-    case ENTRY_DEMO:
-        m_demos.menu.status = "Press Enter to play demo";
-        break;
-    default:
-        m_demos.menu.status = "Press Enter to change directory";
-        break;
+    while (demo_scans < DEMO_SCAN_JOBS && m_demos.numScanning < m_demos.numPending) {
+        if (m_demos.scanPos < m_demos.numDirs || m_demos.scanPos >= m_demos.list.numItems) {
+            m_demos.scanPos = m_demos.numDirs;
+        }
+        e = m_demos.list.items[m_demos.scanPos];
+        if (e->pending && !e->scanning) {
+            ScanName(m_demos.scanPos);
+        }
+        m_demos.scanPos++;
     }
-
-    return QMS_SILENT;
 }
 
 static void BuildList(void)
 {
     int numDirs, numDemos;
     void **dirlist, **demolist;
-    char *cache, *p;
     unsigned flags;
-    size_t len;
+    bool truncated;
     int i;
 
-    // this can be a lengthy process
-    S_StopAllSounds();
-
-    m_demos.menu.status = "Building list...";
-    SCR_UpdateScreen();
+    LoadCache();
+    demo_cache_seq++;
 
     // list files
     flags = ui_listalldemos->integer ? 0 : FS_TYPE_REAL | FS_PATH_GAME;
@@ -291,6 +584,7 @@ static void BuildList(void)
                            FS_SEARCH_DIRSONLY, &numDirs);
     demolist = FS_ListFiles(m_demos.browse, DEMO_EXTENSIONS, flags |
                             FS_SEARCH_EXTRAINFO, &numDemos);
+    truncated = numDemos > MAX_LISTED_FILES - numDirs;
     numDemos = min(numDemos, MAX_LISTED_FILES - numDirs);
 
     // alloc entries
@@ -302,9 +596,8 @@ static void BuildList(void)
     m_demos.widest_map = 3;
     m_demos.widest_pov = 3;
     m_demos.total_bytes = 0;
-
-    // start with minimum size
-    m_demos.menu.size(&m_demos.menu);
+    m_demos.numPending = 0;
+    m_demos.numScanning = 0;
 
     if (strcmp(m_demos.browse, "/")) {
         BuildDir("..", ENTRY_UP);
@@ -319,29 +612,21 @@ static void BuildList(void)
     }
 
     m_demos.numDirs = m_demos.list.numItems;
+    m_demos.scanPos = m_demos.numDirs;
 
     // add demos
     if (demolist) {
-        CalcHash(demolist);
-        if ((cache = LoadCache()) != NULL) {
-            p = cache + 32 + 1;
-            for (i = 0; i < numDemos; i++) {
-                BuildName(demolist[i], &p);
-            }
-            FS_FreeFile(cache);
-        } else {
-            for (i = 0; i < numDemos; i++) {
-                BuildName(demolist[i], NULL);
-                if ((i & 7) == 0) {
-                    m_demos.menu.size(&m_demos.menu);
-                    SCR_UpdateScreen();
-                }
-            }
+        for (i = 0; i < numDemos; i++) {
+            BuildName(demolist[i]);
         }
-        WriteCache();
         FS_FreeList(demolist);
     }
 
+    // forget about removed demos, unless list was truncated
+    if (!truncated) {
+        PruneCache(m_demos.browse);
+    }
+
     // update status line and sort
     Change(&m_demos.list.generic);
     if (m_demos.list.sortdir) {
@@ -352,13 +637,7 @@ static void BuildList(void)
     m_demos.menu.size(&m_demos.menu);
 
     // format our extra status line
-    i = m_demos.list.numItems - m_demos.numDirs;
-    len = Q_scnprintf(m_demos.status, sizeof(m_demos.status),
-                      "%d demo%s, ", i, i == 1 ? "" : "s");
-    Com_FormatSizeLong(m_demos.status + len, sizeof(m_demos.status) - len,
-                       m_demos.total_bytes);
-
-    SCR_UpdateScreen();
+    UpdateStatus();
 }
 
 static void FreeList(void)
@@ -372,6 +651,9 @@ static void FreeList(void)
         Z_Freep(&m_demos.list.items);
         m_demos.list.numItems = 0;
     }
+
+    // invalidate header reads in flight
+    m_demos.generation++;
 }
 
 static menuSound_t LeaveDirectory(void)
@@ -577,6 +859,10 @@ static menuSound_t Keydown(menuFrameWork_t *self, int key)
 
 static void Draw(menuFrameWork_t *self)
 {
+    if (m_demos.numPending) {
+        ScanPending();
+    }
+
     Menu_Draw(self);
     if (uis.width >= 640) {
         UI_DrawString(uis.width, uis.height - CONCHAR_HEIGHT,
@@ -589,6 +875,7 @@ static void Pop(menuFrameWork_t *self)
     // save previous position
     m_demos.selection = m_demos.list.curvalue;
     FreeList();
+    WriteCache();
 }
 
 static void Expose(menuFrameWork_t *self)
@@ -615,6 +902,16 @@ static void Expose(menuFrameWork_t *self)
 
 static void Free(menuFrameWork_t *self)
 {
+    // header reads in flight still update the cache
+    while (demo_scans) {
+        Com_CompleteAsyncWork();
+        if (demo_scans) {
+            Sys_Sleep(1);
+        }
+    }
+
+    WriteCache();
+    FreeCache();
     Z_Free(m_demos.menu.items);
     memset(&m_demos, 0, sizeof(m_demos));
 }
@@ -18,101 +18,566 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "shared/shared.h"
 #include "common/async.h"
+#include "common/common.h"
+#include "common/cvar.h"
 #include "common/zone.h"
 #include "system/pthread.h"
+#include "system/system.h"
 
-static bool work_initialized;
-static bool work_terminate;
-static pthread_mutex_t work_lock;
-static pthread_cond_t work_cond;
-static pthread_t work_thread;
-static asyncwork_t *pend_head;
-static asyncwork_t *done_head;
+/*
+==============================================================================
+
+JOB SYSTEM
+
+Each worker thread owns a deque of jobs. Owner pushes and pops jobs at the
+bottom, idle threads steal from the top of other deques. Threads that are
+not workers (main thread) share deque 0. Threads waiting for a job group
+run queued jobs meanwhile.
+
+Jobs queued with Com_QueueAsyncWork go to a separate FIFO that only workers
+take from, so that long running background work never delays threads
+waiting for job groups.
+
+Deques are protected by their own locks. job_lock protects everything
+else and is never taken while holding a deque lock.
+
+==============================================================================
+*/
+
+#define MAX_WORKERS     16
+#define MAX_JOBS        4096
+#define MAX_GROUPS      256
+#define MAX_DEPENDENTS  8
+#define MAX_RANGES      64
+#define DEQUE_SIZE      1024    // must be power of two
+
+typedef struct job_s {
+    void            (*func)(void *);    // NULL for async work
+    void            *arg;
+    jobgroup_t      *group;
+    asyncwork_t     work;
+    struct job_s    *next;
+} job_t;
+
+struct jobgroup_s {
+    int             pending;    // unfinished jobs, +1 until closed
+    int             blocked;    // unfinished groups this one depends on
+    bool            closed;
+    bool            done;
+    job_t           *held;      // jobs waiting for dependencies
+    jobgroup_t      *dependents[MAX_DEPENDENTS];
+    int             numdependents;
+    jobgroup_t      *next;
+};
 
-static void append_work(asyncwork_t **head, asyncwork_t *work)
+typedef struct {
+    pthread_mutex_t lock;
+    unsigned        top;        // stolen from here
+    unsigned        bottom;     // pushed and popped here
+    job_t           *jobs[DEQUE_SIZE];
+} deque_t;
+
+static cvar_t *com_workers;
+
+static int job_numthreads = -1;     // -1 if not running
+static int job_numdeques;
+static bool job_terminate;
+static pthread_t job_threads[MAX_WORKERS];
+static deque_t job_deques[MAX_WORKERS + 1];
+
+static pthread_mutex_t job_lock;
+static pthread_cond_t job_cond;
+static unsigned job_seq;            // bumped when jobs are queued or groups complete
+static int job_sleepers;
+
+static job_t job_pool[MAX_JOBS];
+static job_t *job_free;
+static jobgroup_t group_pool[MAX_GROUPS];
+static jobgroup_t *group_free;
+
+// background FIFO and completed async work
+static job_t *async_head, **async_tail = &async_head;
+static job_t *done_head, **done_tail = &done_head;
+
+static q_thread_local int job_thread;   // deque index of current thread
+
+static void *worker_func(void *arg);
+
+static void jobs_start(void)
 {
-    asyncwork_t *c, **p;
-    for (p = head, c = *head; c; p = &c->next, c = c->next)
-        ;
-    work->next = NULL;
-    *p = work;
+    int i, n, count = com_workers->integer;
+
+    // default is one thread per CPU core, main thread included. at least one
+    // worker is needed to run async work.
+    if (count <= 0)
+        count = Sys_NumCPUs() - 1;
+    count = Q_clip(count, 1, MAX_WORKERS);
+
+    pthread_mutex_init(&job_lock, NULL);
+    pthread_cond_init(&job_cond, NULL);
+
+    for (i = 0; i <= MAX_WORKERS; i++) {
+        pthread_mutex_init(&job_deques[i].lock, NULL);
+        job_deques[i].top = job_deques[i].bottom = 0;
+    }
+
+    job_free = NULL;
+    for (i = MAX_JOBS - 1; i >= 0; i--) {
+        job_pool[i].next = job_free;
+        job_free = &job_pool[i];
+    }
+
+    group_free = NULL;
+    for (i = MAX_GROUPS - 1; i >= 0; i--) {
+        group_pool[i].next = group_free;
+        group_free = &group_pool[i];
+    }
+
+    job_numdeques = count + 1;
+
+    for (n = 0; n < count; n++) {
+        if (pthread_create(&job_threads[n], NULL, worker_func, (void *)(intptr_t)(n + 1))) {
+            Com_WPrintf("Couldn't create worker thread\n");
+            break;
+        }
+    }
+
+    job_numthreads = n;
+    Com_DPrintf("Started %d worker threads\n", job_numthreads);
+}
+
+// called with job_lock held
+static void wake_threads(void)
+{
+    job_seq++;
+    if (job_sleepers)
+        pthread_cond_broadcast(&job_cond);
+}
+
+static bool push_job(job_t *job)
+{
+    deque_t *d = &job_deques[job_thread];
+    bool ok;
+
+    pthread_mutex_lock(&d->lock);
+    ok = d->bottom - d->top < DEQUE_SIZE;
+    if (ok)
+        d->jobs[d->bottom++ & (DEQUE_SIZE - 1)] = job;
+    pthread_mutex_unlock(&d->lock);
+
+    return ok;
+}
+
+static job_t *pop_job(deque_t *d)
+{
+    job_t *job = NULL;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom != d->top)
+        job = d->jobs[--d->bottom & (DEQUE_SIZE - 1)];
+    pthread_mutex_unlock(&d->lock);
+
+    return job;
+}
+
+static job_t *steal_job(deque_t *d)
+{
+    job_t *job = NULL;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->bottom != d->top)
+        job = d->jobs[d->top++ & (DEQUE_SIZE - 1)];
+    pthread_mutex_unlock(&d->lock);
+
+    return job;
+}
+
+static job_t *find_job(void)
+{
+    job_t *job;
+    int i;
+
+    job = pop_job(&job_deques[job_thread]);
+    for (i = 1; !job && i < job_numdeques; i++)
+        job = steal_job(&job_deques[(job_thread + i) % job_numdeques]);
+
+    return job;
+}
+
+// called with job_lock held. group completes once it is closed, all its
+// jobs are done and all groups it depends on are complete. jobs of
+// dependent groups that become runnable are returned in *list.
+static void check_group(jobgroup_t *group, job_t **list)
+{
+    jobgroup_t *dep;
+    job_t *job;
+    int i;
+
+    if (group->pending || group->blocked || group->done)
+        return;
+
+    group->done = true;
+
+    for (i = 0; i < group->numdependents; i++) {
+        dep = group->dependents[i];
+        if (--dep->blocked)
+            continue;
+        while ((job = dep->held) != NULL) {
+            dep->held = job->next;
+            job->next = *list;
+            *list = job;
+        }
+        check_group(dep, list);
+    }
+    group->numdependents = 0;
+
+    wake_threads();
+}
+
+static void run_job(job_t *job);
+
+static void submit_jobs(job_t *list)
+{
+    job_t *job, *next;
+    bool queued = false;
+
+    for (job = list; job; job = next) {
+        next = job->next;
+        if (push_job(job))
+            queued = true;
+        else
+            run_job(job);   // deque is full
+    }
+
+    if (queued) {
+        pthread_mutex_lock(&job_lock);
+        wake_threads();
+        pthread_mutex_unlock(&job_lock);
+    }
+}
+
+static void run_job(job_t *job)
+{
+    jobgroup_t *group = job->group;
+    job_t *list = NULL;
+
+    if (job->func)
+        job->func(job->arg);
+    else
+        job->work.work_cb(job->work.cb_arg);
+
+    pthread_mutex_lock(&job_lock);
+    if (group) {
+        group->pending--;
+        check_group(group, &list);
+    }
+    if (job->func) {
+        job->next = job_free;
+        job_free = job;
+    } else {
+        job->next = NULL;
+        *done_tail = job;
+        done_tail = &job->next;
+    }
+    pthread_mutex_unlock(&job_lock);
+
+    submit_jobs(list);
 }
 
-static void *work_func(void *arg)
+static void *worker_func(void *arg)
 {
-    pthread_mutex_lock(&work_lock);
+    unsigned seq;
+    job_t *job;
+
+    job_thread = (intptr_t)arg;
+
     while (1) {
-        while (!pend_head && !work_terminate)
-            pthread_cond_wait(&work_cond, &work_lock);
+        pthread_mutex_lock(&job_lock);
+        seq = job_seq;
+        pthread_mutex_unlock(&job_lock);
 
-        asyncwork_t *work = pend_head;
-        if (!work)
-            break;
-        pend_head = work->next;
+        job = find_job();
+        if (job) {
+            // nothing can be held by this thread between jobs
+            Z_FrameRelease(0);
+            run_job(job);
+            continue;
+        }
 
-        pthread_mutex_unlock(&work_lock);
-        work->work_cb(work->cb_arg);
-        pthread_mutex_lock(&work_lock);
+        pthread_mutex_lock(&job_lock);
+        job = async_head;
+        if (job) {
+            async_head = job->next;
+            if (!async_head)
+                async_tail = &async_head;
+        } else if (job_terminate) {
+            pthread_mutex_unlock(&job_lock);
+            break;
+        } else if (seq == job_seq) {
+            job_sleepers++;
+            pthread_cond_wait(&job_cond, &job_lock);
+            job_sleepers--;
+        }
+        pthread_mutex_unlock(&job_lock);
 
-        append_work(&done_head, work);
+        if (job) {
+            Z_FrameRelease(0);
+            run_job(job);
+        }
     }
-    pthread_mutex_unlock(&work_lock);
 
+    Z_FrameShutdown();
     return NULL;
 }
 
-void Com_QueueAsyncWork(asyncwork_t *work)
+// pools are started once here rather than on first use, which may be
+// from any thread
+void Com_InitAsyncWork(void)
+{
+    com_workers = Cvar_Get("com_workers", "0", CVAR_NOSET);
+    jobs_start();
+}
+
+jobgroup_t *Com_CreateJobGroup(void)
 {
-    if (!work_initialized) {
-        pthread_mutex_init(&work_lock, NULL);
-        pthread_cond_init(&work_cond, NULL);
-        if (pthread_create(&work_thread, NULL, work_func, NULL))
-            Com_Error(ERR_FATAL, "Couldn't create async work thread");
-        work_initialized = true;
+    jobgroup_t *group;
+
+    Q_assert(job_numthreads >= 0);
+
+    pthread_mutex_lock(&job_lock);
+    group = group_free;
+    if (group)
+        group_free = group->next;
+    pthread_mutex_unlock(&job_lock);
+
+    if (!group)
+        Com_Error(ERR_FATAL, "%s: too many job groups", __func__);
+
+    group->pending = 1;
+    group->blocked = 0;
+    group->closed = false;
+    group->done = false;
+    group->held = NULL;
+    group->numdependents = 0;
+    group->next = NULL;
+    return group;
+}
+
+void Com_AddJobDependency(jobgroup_t *group, jobgroup_t *dep)
+{
+    pthread_mutex_lock(&job_lock);
+    Q_assert(!group->closed && group->pending == 1);
+    if (!dep->done) {
+        Q_assert(dep->numdependents < MAX_DEPENDENTS);
+        dep->dependents[dep->numdependents++] = group;
+        group->blocked++;
     }
+    pthread_mutex_unlock(&job_lock);
+}
+
+void Com_AddJob(jobgroup_t *group, void (*func)(void *), void *arg)
+{
+    job_t *job;
 
-    pthread_mutex_lock(&work_lock);
-    append_work(&pend_head, Z_CopyStruct(work));
-    pthread_mutex_unlock(&work_lock);
+    pthread_mutex_lock(&job_lock);
+    Q_assert(!group->closed);
+    job = job_free;
+    if (job) {
+        job_free = job->next;
+        job->func = func;
+        job->arg = arg;
+        job->group = group;
+        job->next = NULL;
+        group->pending++;
+        if (group->blocked) {
+            job->next = group->held;
+            group->held = job;
+            job = NULL;
+        }
+    } else if (group->blocked) {
+        pthread_mutex_unlock(&job_lock);
+        Com_Error(ERR_FATAL, "%s: too many jobs", __func__);
+    } else {
+        // out of jobs, just run it now
+        pthread_mutex_unlock(&job_lock);
+        func(arg);
+        return;
+    }
+    pthread_mutex_unlock(&job_lock);
 
-    pthread_cond_signal(&work_cond);
+    if (job)
+        submit_jobs(job);
+}
+
+void Com_CloseJobGroup(jobgroup_t *group)
+{
+    job_t *list = NULL;
+
+    pthread_mutex_lock(&job_lock);
+    if (!group->closed) {
+        group->closed = true;
+        group->pending--;
+        check_group(group, &list);
+    }
+    pthread_mutex_unlock(&job_lock);
+
+    submit_jobs(list);
+}
+
+void Com_WaitJobGroup(jobgroup_t *group)
+{
+    unsigned seq;
+    job_t *job;
+
+    Com_CloseJobGroup(group);
+
+    pthread_mutex_lock(&job_lock);
+    while (!group->done) {
+        seq = job_seq;
+        pthread_mutex_unlock(&job_lock);
+
+        // help out instead of blocking
+        job = find_job();
+        if (job)
+            run_job(job);
+
+        pthread_mutex_lock(&job_lock);
+        if (!job && !group->done && seq == job_seq) {
+            job_sleepers++;
+            pthread_cond_wait(&job_cond, &job_lock);
+            job_sleepers--;
+        }
+    }
+
+    group->next = group_free;
+    group_free = group;
+    pthread_mutex_unlock(&job_lock);
+}
+
+typedef struct {
+    void    (*func)(void *, int);
+    void    *arg;
+    int     start, end;
+} jobrange_t;
+
+static void run_range(void *arg)
+{
+    jobrange_t *r = arg;
+
+    for (int i = r->start; i < r->end; i++)
+        r->func(r->arg, i);
+}
+
+void Com_ParallelFor(int count, void (*func)(void *, int), void *arg)
+{
+    jobrange_t ranges[MAX_RANGES];
+    jobgroup_t *group;
+    int i, n, start;
+
+    if (count < 2 || job_numthreads < 1) {
+        for (i = 0; i < count; i++)
+            func(arg, i);
+        return;
+    }
+
+    // split into a few ranges per thread for load balancing
+    n = min(count, min((job_numthreads + 1) * 4, MAX_RANGES));
+
+    group = Com_CreateJobGroup();
+    for (i = start = 0; i < n; i++) {
+        ranges[i].func = func;
+        ranges[i].arg = arg;
+        ranges[i].start = start;
+        ranges[i].end = start += (count - start) / (n - i);
+        Com_AddJob(group, run_range, &ranges[i]);
+    }
+    Com_WaitJobGroup(group);
+}
+
+void Com_QueueAsyncWork(asyncwork_t *work)
+{
+    job_t *job = NULL;
+
+    if (job_numthreads > 0) {
+        pthread_mutex_lock(&job_lock);
+        job = job_free;
+        if (job) {
+            job_free = job->next;
+            job->func = NULL;
+            job->arg = NULL;
+            job->group = NULL;
+            job->work = *work;
+            job->next = NULL;
+            *async_tail = job;
+            async_tail = &job->next;
+            wake_threads();
+        }
+        pthread_mutex_unlock(&job_lock);
+    }
+
+    // no workers, shut down or out of jobs, do it synchronously
+    if (!job) {
+        work->work_cb(work->cb_arg);
+        if (work->done_cb)
+            work->done_cb(work->cb_arg);
+    }
 }
 
 void Com_CompleteAsyncWork(void)
 {
-    asyncwork_t *work, *next;
+    job_t *job, *next, *list;
 
-    if (!work_initialized)
+    if (job_numthreads < 0)
         return;
-    if (pthread_mutex_trylock(&work_lock))
+
+    pthread_mutex_lock(&job_lock);
+    list = done_head;
+    done_head = NULL;
+    done_tail = &done_head;
+    pthread_mutex_unlock(&job_lock);
+
+    if (q_likely(!list))
         return;
-    if (q_unlikely(done_head)) {
-        for (work = done_head; work; work = next) {
-            next = work->next;
-            if (work->done_cb)
-                work->done_cb(work->cb_arg);
-            Z_Free(work);
-        }
-        done_head = NULL;
+
+    for (job = list; job; job = job->next) {
+        if (job->work.done_cb)
+            job->work.done_cb(job->work.cb_arg);
     }
-    pthread_mutex_unlock(&work_lock);
+
+    pthread_mutex_lock(&job_lock);
+    for (job = list; job; job = next) {
+        next = job->next;
+        job->next = job_free;
+        job_free = job;
+    }
+    pthread_mutex_unlock(&job_lock);
 }
 
 void Com_ShutdownAsyncWork(void)
 {
-    if (!work_initialized)
+    int i;
+
+    if (job_numthreads < 0)
         return;
 
-    pthread_mutex_lock(&work_lock);
-    work_terminate = true;
-    pthread_mutex_unlock(&work_lock);
+    // workers finish all queued work before exiting
+    pthread_mutex_lock(&job_lock);
+    job_terminate = true;
+    wake_threads();
+    pthread_mutex_unlock(&job_lock);
 
-    pthread_cond_signal(&work_cond);
+    for (i = 0; i < job_numthreads; i++)
+        Q_assert(!pthread_join(job_threads[i], NULL));
 
-    Q_assert(!pthread_join(work_thread, NULL));
     Com_CompleteAsyncWork();
 
-    pthread_mutex_destroy(&work_lock);
-    pthread_cond_destroy(&work_cond);
-    work_initialized = false;
+    for (i = 0; i <= MAX_WORKERS; i++)
+        pthread_mutex_destroy(&job_deques[i].lock);
+    pthread_mutex_destroy(&job_lock);
+    pthread_cond_destroy(&job_cond);
+
+    async_head = NULL;
+    async_tail = &async_head;
+    job_numthreads = -1;
+    job_terminate = false;
 }
@@ -813,8 +813,8 @@ Loads in the map and all submodels
 int BSP_Load(const char *name, bsp_t **bsp_p)
 {
     bsp_t           *bsp;
-    byte            *buf;
-    dheader_t       *header;
+    const byte      *buf;
+    const dheader_t *header;
     const lump_info_t *info;
     uint32_t        filelen, ofs, len, count, maxpos;
     int             i, ret;
@@ -841,7 +841,7 @@ int BSP_Load(const char *name, bsp_t **bsp_p)
     //
     // load the file
     //
-    filelen = FS_LoadFile(name, (void **)&buf);
+    filelen = FS_MapFile(name, (const void **)&buf);
     if (!buf) {
         return filelen;
     }
@@ -852,7 +852,7 @@ int BSP_Load(const char *name, bsp_t **bsp_p)
     }
 
     // byte swap and validate the header
-    header = (dheader_t *)buf;
+    header = (const dheader_t *)buf;
     switch (LittleLong(header->ident)) {
     case IDBSPHEADER:
         break;
@@ -955,7 +955,7 @@ int BSP_Load(const char *name, bsp_t **bsp_p)
 
     List_Append(&bsp_cache, &bsp->entry);
 
-    FS_FreeFile(buf);
+    FS_UnmapFile(buf);
 
     *bsp_p = bsp;
     return Q_ERR_SUCCESS;
@@ -964,7 +964,7 @@ fail1:
     Hunk_Free(&bsp->hunk);
     Z_Free(bsp);
 fail2:
-    FS_FreeFile(buf);
+    FS_UnmapFile(buf);
     return ret;
 }
 
@@ -356,31 +356,34 @@ CM_BoxLeafnums
 Fills in a list of all the leafs touched
 =============
 */
-static int              leaf_count, leaf_maxcount;
-static const mleaf_t    **leaf_list;
-static const vec_t      *leaf_mins, *leaf_maxs;
-static const mnode_t    *leaf_topnode;
-
-static void CM_BoxLeafs_r(const mnode_t *node)
+typedef struct {
+    int             count, maxcount;
+    const mleaf_t   **list;
+    const vec_t     *mins, *maxs;
+    const mnode_t   *topnode;
+} boxleafs_t;
+
+// reentrant, used from multiple threads for building client frames
+static void CM_BoxLeafs_r(boxleafs_t *b, const mnode_t *node)
 {
     while (node->plane) {
-        box_plane_t s = BoxOnPlaneSideFast(leaf_mins, leaf_maxs, node->plane);
+        box_plane_t s = BoxOnPlaneSideFast(b->mins, b->maxs, node->plane);
         if (s == BOX_INFRONT) {
             node = node->children[0];
         } else if (s == BOX_BEHIND) {
             node = node->children[1];
         } else {
             // go down both
-            if (!leaf_topnode) {
-                leaf_topnode = node;
+            if (!b->topnode) {
+                b->topnode = node;
             }
-            CM_BoxLeafs_r(node->children[0]);
+            CM_BoxLeafs_r(b, node->children[0]);
             node = node->children[1];
         }
     }
 
-    if (leaf_count < leaf_maxcount) {
-        leaf_list[leaf_count++] = (const mleaf_t *)node;
+    if (b->count < b->maxcount) {
+        b->list[b->count++] = (const mleaf_t *)node;
     }
 }
 
@@ -388,20 +391,19 @@ int CM_BoxLeafs_headnode(const vec3_t mins, const vec3_t maxs,
                          const mleaf_t **list, int listsize,
                          const mnode_t *headnode, const mnode_t **topnode)
 {
-    leaf_list = list;
-    leaf_count = 0;
-    leaf_maxcount = listsize;
-    leaf_mins = mins;
-    leaf_maxs = maxs;
-
-    leaf_topnode = NULL;
+    boxleafs_t b = {
+        .maxcount = listsize,
+        .list = list,
+        .mins = mins,
+        .maxs = maxs,
+    };
 
-    CM_BoxLeafs_r(headnode);
+    CM_BoxLeafs_r(&b, headnode);
 
     if (topnode)
-        *topnode = leaf_topnode;
+        *topnode = b.topnode;
 
-    return leaf_count;
+    return b.count;
 }
 
 /*
@@ -80,6 +80,8 @@ static int      com_argc;
 cvar_t  *z_perturb;
 #endif
 
+cvar_t  *z_profile_rate;
+
 #if USE_DEBUG
 cvar_t  *developer;
 #endif
@@ -633,12 +635,13 @@ void Com_Quit(const char *reason, error_type_t type)
     }
 
     SV_Shutdown(buffer, type);
+    // finish async work while subsystems its callbacks use are still up
+    Com_ShutdownAsyncWork();
     CL_Shutdown();
     NET_Shutdown();
     Sys_SaveHistory();
     logfile_close();
     FS_Shutdown();
-    Com_ShutdownAsyncWork();
 
     Sys_Quit();
     // doesn't get there
@@ -906,6 +909,7 @@ void Qcommon_Init(int argc, char **argv)
 #if USE_TESTS
     z_perturb = Cvar_Get("z_perturb", "0", 0);
 #endif
+    z_profile_rate = Cvar_Get("z_profile_rate", "0", 0);
 #if USE_CLIENT
     host_speeds = Cvar_Get("host_speeds", "0", 0);
 #endif
@@ -966,6 +970,7 @@ void Qcommon_Init(int argc, char **argv)
 #endif
 
     Cmd_AddCommand("z_stats", Z_Stats_f);
+    Cmd_AddCommand("z_profile", Z_Profile_f);
 
     //Cmd_AddCommand("setenv", Com_Setenv_f);
 
@@ -987,6 +992,8 @@ void Qcommon_Init(int argc, char **argv)
 
     Sys_Init();
 
+    Com_InitAsyncWork();
+
     Sys_RunConsole();
 
     FS_Init();
@@ -1078,6 +1085,8 @@ void Qcommon_Frame(void)
         return; // an ERR_DROP was thrown
     }
 
+    Z_FrameReset();
+
     Com_CompleteAsyncWork();
 
 #if USE_CLIENT
@@ -0,0 +1,203 @@
+/*
+Copyright (C) 2003-2006 Andrey Nazarov
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+//
+// demoindex.c -- persistent demo seek index
+//
+// Snapshots built during demo playback are saved in a sidecar .idx file,
+// so that seeking in a demo that was played before is near-instant.
+// Index is validated against demo size and modification time.
+//
+
+#include "shared/shared.h"
+#include "common/common.h"
+#include "common/demoindex.h"
+#include "common/files.h"
+#include "common/intreadwrite.h"
+#include "common/protocol.h"
+
+#define INDEX_MAGIC     MakeLittleLong('D','I','D','X')
+#define INDEX_VERSION   1
+
+#define HEADER_SIZE     32
+#define ENTRY_SIZE      16
+
+void Demo_InitIndex(demoindex_t *index, const char *demopath, qhandle_t f, unsigned type)
+{
+    int64_t size = FS_Length(f);
+    int64_t mtime = FS_Mtime(f);
+
+    memset(index, 0, sizeof(*index));
+
+    if (size <= 0 || mtime < 0)
+        return;
+
+    if (Q_concat(index->path, sizeof(index->path), demopath, ".idx") >= sizeof(index->path)) {
+        index->path[0] = 0;
+        return;
+    }
+
+    index->type = type;
+    index->demosize = size;
+    index->mtime = mtime;
+}
+
+/*
+============
+Demo_LoadIndex
+
+Returns number of snapshots loaded. Should be called once the first demo
+frame is parsed.
+============
+*/
+int Demo_LoadIndex(demoindex_t *index, demosnap_t ***snapshots, memtag_t tag)
+{
+    byte header[HEADER_SIZE], entry[ENTRY_SIZE];
+    demosnap_t **list, *snap;
+    qhandle_t f;
+    int64_t pos;
+    int i, num, ret;
+    unsigned msglen;
+
+    *snapshots = NULL;
+
+    if (!index->path[0] || index->loaded)
+        return 0;
+
+    index->loaded = true;
+
+    FS_OpenFile(index->path, &f, FS_MODE_READ);
+    if (!f)
+        return 0;
+
+    ret = FS_Read(header, sizeof(header), f);
+    if (ret != sizeof(header))
+        goto fail;
+
+    if (RL32(header) != INDEX_MAGIC || RL32(header + 4) != INDEX_VERSION || RL32(header + 8) != index->type)
+        goto fail;
+
+    // stale index for modified demo
+    if (RL64(header + 16) != index->demosize || RL64(header + 24) != index->mtime)
+        goto fail;
+
+    num = RL32(header + 12);
+    if (num <= 0 || num > MAX_LOADFILE / ENTRY_SIZE)
+        goto fail;
+
+    list = Z_TagMallocz(sizeof(list[0]) * num, tag);
+
+    for (i = 0, pos = -1; i < num; i++) {
+        ret = FS_Read(entry, sizeof(entry), f);
+        if (ret != sizeof(entry))
+            break;
+
+        msglen = RL32(entry + 4);
+        if (msglen > MAX_MSGLEN)
+            break;
+
+        // must be sorted for binary search
+        if ((int64_t)RL64(entry + 8) <= pos)
+            break;
+
+        snap = Z_TagMalloc(sizeof(*snap) + msglen - 1, tag);
+        snap->framenum = RL32(entry);
+        snap->msglen = msglen;
+        snap->filepos = pos = RL64(entry + 8);
+        list[i] = snap;
+
+        ret = FS_Read(snap->data, msglen, f);
+        if (ret != msglen) {
+            Z_Free(snap);
+            break;
+        }
+    }
+
+    if (i < num) {
+        while (i--)
+            Z_Free(list[i]);
+        Z_Free(list);
+        goto fail;
+    }
+
+    FS_CloseFile(f);
+
+    Com_DPrintf("Loaded %d snapshots from %s\n", num, index->path);
+    index->numloaded = num;
+    *snapshots = list;
+    return num;
+
+fail:
+    Com_DPrintf("Ignoring invalid demo index %s\n", index->path);
+    FS_CloseFile(f);
+    return 0;
+}
+
+/*
+============
+Demo_WriteIndex
+
+Saves snapshots if any new ones were built during playback. Stops indexing
+after that, later gamestates are not indexed.
+============
+*/
+void Demo_WriteIndex(demoindex_t *index, demosnap_t **snapshots, int numsnapshots)
+{
+    byte header[HEADER_SIZE], entry[ENTRY_SIZE];
+    demosnap_t *snap;
+    qhandle_t f;
+    int i, ret;
+
+    if (!index->path[0] || !index->loaded)
+        return;
+
+    if (numsnapshots <= index->numloaded)
+        goto done;
+
+    FS_OpenFile(index->path, &f, FS_MODE_WRITE);
+    if (!f)
+        goto done;
+
+    WL32(header, INDEX_MAGIC);
+    WL32(header + 4, INDEX_VERSION);
+    WL32(header + 8, index->type);
+    WL32(header + 12, numsnapshots);
+    WL64(header + 16, index->demosize);
+    WL64(header + 24, index->mtime);
+    FS_Write(header, sizeof(header), f);
+
+    for (i = 0; i < numsnapshots; i++) {
+        snap = snapshots[i];
+        WL32(entry, snap->framenum);
+        WL32(entry + 4, snap->msglen);
+        WL64(entry + 8, snap->filepos);
+        FS_Write(entry, sizeof(entry), f);
+        FS_Write(snap->data, snap->msglen, f);
+    }
+
+    // truncated index is rejected on load
+    ret = FS_CloseFile(f);
+    if (ret < 0) {
+        Com_WPrintf("Couldn't write %s: %s\n", index->path, Q_ErrorString(ret));
+    } else {
+        Com_DPrintf("Wrote %d snapshots to %s\n", numsnapshots, index->path);
+    }
+
+done:
+    index->path[0] = 0;
+}
@@ -18,6 +18,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 #include "shared/shared.h"
 #include "shared/list.h"
+#include "common/async.h"
 #include "common/common.h"
 #include "common/cvar.h"
 #include "common/error.h"
@@ -26,6 +27,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "common/intreadwrite.h"
 #include "common/mapdb.h"
 #include "system/system.h"
+#include "system/pthread.h"
 #include "client/client.h"
 #include "server/server.h"
 #include "format/pak.h"
@@ -153,7 +155,12 @@ typedef struct packfile_s {
 typedef struct {
     filetype_t  type;       // FS_PAK, FS_ZIP or FS_BUILTIN
     unsigned    refcount;   // for tracking pack users
-    FILE        *fp;
+    FILE        *fp;        // entries are read with Sys_ReadAt
+    byte        *map;       // read-only mapping of entire pack, if any
+    int64_t     mapsize;
+    bool        mapfailed;  // don't retry mapping
+    int64_t     size;       // file size and mtime for pack cache,
+    int64_t     mtime;      // zero if unknown
     unsigned    num_files;
     unsigned    hash_size;
     packfile_t  *files;
@@ -169,6 +176,24 @@ typedef struct searchpath_s {
     char        filename[1];
 } searchpath_t;
 
+// double buffered writer for FS_FLAG_ASYNC files. Main thread fills one
+// buffer while background thread writes (and compresses) the other one.
+#define ASYNC_BUFSIZE   0x10000
+
+typedef struct {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  work_cond;  // signaled when buffer is submitted
+    pthread_cond_t  done_cond;  // signaled when buffer is written
+    byte            *buffers[2];
+    int             current;    // buffer being filled by main thread
+    size_t          cursize;
+    size_t          pending;    // size of buffer being written, 0 if idle
+    int             error;      // first write error from background thread
+    int64_t         position;   // total bytes accepted
+    bool            terminate;
+} asyncwrite_t;
+
 typedef struct {
     filetype_t  type;
     unsigned    mode;
@@ -181,6 +206,8 @@ typedef struct {
     int         error;      // stream error indicator from read/write operation
     int64_t     position;   // reading position for FS_PAK/FS_ZIP/FS_BUILTIN
     int64_t     length;     // total cached file length
+    int64_t     mtime;      // modification time for FS_REAL/FS_GZ
+    asyncwrite_t    *async; // background writer for FS_FLAG_ASYNC
 } file_t;
 
 typedef struct {
@@ -204,8 +231,6 @@ static list_t       fs_soft_links;
 static file_t       fs_files[MAX_FILE_HANDLES];
 static int          fs_num_files;
 
-static bool         fs_non_uniq_open;
-
 #if USE_DEBUG
 static unsigned     fs_count_read;
 static unsigned     fs_count_open;
@@ -215,14 +240,89 @@ static unsigned     fs_count_strlwr;
 #define FS_COUNT_OPEN       fs_count_open++
 #define FS_COUNT_STRCMP     fs_count_strcmp++
 #define FS_COUNT_STRLWR     fs_count_strlwr++
+#define FS_COUNT_NEGCACHE   fs_count_negcache++
 #else
 #define FS_COUNT_READ       (void)0
 #define FS_COUNT_OPEN       (void)0
 #define FS_COUNT_STRCMP     (void)0
 #define FS_COUNT_STRLWR     (void)0
+#define FS_COUNT_NEGCACHE   (void)0
 #endif
 
 static cvar_t       *fs_autoexec;
+static cvar_t       *fs_mmap;
+static cvar_t       *fs_packcache;
+#if USE_ZLIB
+static cvar_t       *fs_zipcache;
+#endif
+
+// views into pack mappings handed out by FS_MapFile
+#define MAX_MAPPED_FILES    32
+
+typedef struct {
+    const void  *data;
+    int64_t     size;
+    pack_t      *pack;
+} mappedfile_t;
+
+static mappedfile_t fs_mapped[MAX_MAPPED_FILES];
+
+// merged index of all pack entries, kept in search path order. rebuilt
+// every time search paths change.
+typedef struct pathindex_s {
+    struct pathindex_s  *next;
+    searchpath_t        *search;
+    packfile_t          *entry;
+} pathindex_t;
+
+static pathindex_t  **fs_index_hash;
+static pathindex_t  *fs_index_nodes;
+static unsigned     fs_index_size;
+
+// bounded cache of paths known to be missing from loose directories.
+// flushed when search paths change and when files are created.
+#define NEGCACHE_SIZE   4096    // must be power of two
+
+typedef struct {
+    unsigned        gen;
+    unsigned        hash;
+    searchpath_t    *search;
+    char            path[MAX_QPATH];
+} negcache_t;
+
+static negcache_t   fs_negcache[NEGCACHE_SIZE];
+static unsigned     fs_negcache_gen = 1;
+
+#if USE_ZLIB
+// LRU of inflated zip entries, keyed by pack path, size, mtime and entry
+// name so that it survives fs_restart
+#define ZIPCACHE_HASH   256
+
+typedef struct zipcache_s {
+    list_t      entry;          // LRU order, most recent first
+    struct zipcache_s *hash_next;
+    unsigned    hash;
+    int64_t     packsize;
+    int64_t     packmtime;
+    int64_t     len;
+    const char  *name;          // points into key
+    byte        *data;
+    char        key[1];         // pack filename, NUL, entry name, NUL
+} zipcache_t;
+
+static zipcache_t   *fs_zipcache_hash[ZIPCACHE_HASH];
+static LIST_DECL(fs_zipcache_lru);
+static size_t       fs_zipcache_size;
+static unsigned     fs_zipcache_hits;
+static unsigned     fs_zipcache_misses;
+#endif
+
+#if USE_DEBUG
+static unsigned     fs_count_negcache;
+static unsigned     fs_count_mapped;
+static unsigned     fs_count_copied;
+static uint64_t     fs_bytes_mapped;
+#endif
 
 #if USE_DEBUG
 static cvar_t       *fs_debug;
@@ -231,8 +331,9 @@ static cvar_t       *fs_debug;
 cvar_t              *fs_game;
 
 #if USE_ZLIB
-// local stream used for all file loads
+// local stream used for file loads, unless already in use
 static zipstream_t  fs_zipstream;
+static bool         fs_zipstream_busy;
 
 static void open_zip_file(file_t *file);
 static void close_zip_file(file_t *file);
@@ -245,6 +346,11 @@ static int seek_zip_file(file_t *file, int64_t offset, int whence);
 static pack_t *pack_get(pack_t *pack);
 static void pack_put(pack_t *pack);
 
+static int get_path_info(const char *path, file_info_t *info);
+
+static int async_drain(file_t *file);
+static int async_close(file_t *file);
+
 /*
 
 All of Quake's data access is through a hierchal file system,
@@ -494,6 +600,35 @@ int64_t FS_Length(qhandle_t f)
     return file->length;
 }
 
+/*
+============
+FS_Mtime
+
+Returns modification time of the file, or of the pack file is from.
+============
+*/
+int64_t FS_Mtime(qhandle_t f)
+{
+    file_t *file = file_for_handle(f);
+    file_info_t info;
+    int ret;
+
+    if (!file)
+        return Q_ERR(EBADF);
+
+    if (!file->pack)
+        return file->mtime;
+
+    if (file->pack->type == FS_BUILTIN)
+        return 0;
+
+    ret = get_path_info(file->pack->filename, &info);
+    if (ret)
+        return ret;
+
+    return info.mtime;
+}
+
 /*
 ============
 FS_Tell
@@ -507,6 +642,9 @@ int64_t FS_Tell(qhandle_t f)
     if (!file)
         return Q_ERR(EBADF);
 
+    if (file->async)
+        return file->async->position;
+
     switch (file->type) {
     case FS_REAL:
         ret = os_ftell(file->fp);
@@ -562,9 +700,6 @@ static int seek_pak_file(file_t *file, int64_t offset, int whence)
     if (entry->filepos > INT64_MAX - offset)
         return Q_ERR(EOVERFLOW);
 
-    if (os_fseek(file->fp, entry->filepos + offset, SEEK_SET))
-        return Q_ERRNO;
-
     file->position = offset;
     return Q_ERR_SUCCESS;
 }
@@ -594,6 +729,9 @@ int FS_Seek(qhandle_t f, int64_t offset, int whence)
     if (!file)
         return Q_ERR(EBADF);
 
+    if (file->async)
+        return Q_ERR(ESPIPE);
+
     switch (file->type) {
     case FS_REAL:
         if (os_fseek(file->fp, offset, whence)) {
@@ -632,6 +770,9 @@ int FS_CreatePath(char *path)
     char *ofs;
     int ret;
 
+    // new file is about to appear
+    FS_FlushNegativeCache();
+
     ofs = path;
 
 #ifdef _WIN32
@@ -677,34 +818,24 @@ int FS_CreatePath(char *path)
     return Q_ERR_SUCCESS;
 }
 
-/*
-==============
-FS_CloseFile
-==============
-*/
-int FS_CloseFile(qhandle_t f)
+static int close_file(file_t *file)
 {
-    file_t *file = file_for_handle(f);
-    int ret;
+    int ret = file->error;
 
-    if (!file)
-        return Q_ERR(EBADF);
+    if (file->async) {
+        int err = async_close(file);
+        if (!ret)
+            ret = err;
+    }
 
-    ret = file->error;
     switch (file->type) {
     case FS_REAL:
         if (fclose(file->fp))
             ret = Q_ERRNO;
         break;
     case FS_PAK:
-        if (IS_UNIQUE(file)) {
-            fclose(file->fp);
-            pack_put(file->pack);
-        } else {
-            fs_non_uniq_open = false;
-        }
-        break;
     case FS_BUILTIN:
+        pack_put(file->pack);
         break;
 #if USE_ZLIB
     case FS_GZ:
@@ -712,12 +843,8 @@ int FS_CloseFile(qhandle_t f)
             ret = Q_ERR_LIBRARY_ERROR;
         break;
     case FS_ZIP:
-        if (IS_UNIQUE(file)) {
-            close_zip_file(file);
-            pack_put(file->pack);
-        } else {
-            fs_non_uniq_open = false;
-        }
+        close_zip_file(file);
+        pack_put(file->pack);
         break;
 #endif
     default:
@@ -728,6 +855,21 @@ int FS_CloseFile(qhandle_t f)
     return ret;
 }
 
+/*
+==============
+FS_CloseFile
+==============
+*/
+int FS_CloseFile(qhandle_t f)
+{
+    file_t *file = file_for_handle(f);
+
+    if (!file)
+        return Q_ERR(EBADF);
+
+    return close_file(file);
+}
+
 static int get_path_info(const char *path, file_info_t *info)
 {
     Q_STATBUF st;
@@ -970,6 +1112,7 @@ static int check_header_coherency(FILE *fp, packfile_t *entry)
 {
     unsigned ofs, flags, comp_mtd, comp_len, file_len, name_size, xtra_size;
     byte header[ZIP_SIZELOCALHEADER];
+    int64_t ret;
 
     if (entry->coherent)
         return Q_ERR_SUCCESS;
@@ -981,10 +1124,11 @@ static int check_header_coherency(FILE *fp, packfile_t *entry)
     if (entry->compmtd != 0 && entry->compmtd != Z_DEFLATED)
         return Q_ERR_BAD_COMPRESSION;
 
-    if (os_fseek(fp, entry->filepos, SEEK_SET))
-        return Q_ERRNO;
-    if (!fread(header, sizeof(header), 1, fp))
-        return FS_ERR_READ(fp);
+    ret = Sys_ReadAt(fp, header, sizeof(header), entry->filepos);
+    if (ret < 0)
+        return ret;
+    if (ret != sizeof(header))
+        return Q_ERR_UNEXPECTED_EOF;
 
     // check the magic
     if (RL32(&header[0]) != ZIP_LOCALHEADERMAGIC)
@@ -1018,14 +1162,20 @@ static int check_header_coherency(FILE *fp, packfile_t *entry)
     return Q_ERR_SUCCESS;
 }
 
+// streams inflated on worker threads (non-NULL opaque) can't use zone
 static voidpf FS_zalloc(voidpf opaque, uInt items, uInt size)
 {
+    if (opaque)
+        return malloc((size_t)items * size);
     return FS_Malloc((size_t)items * size);
 }
 
 static void FS_zfree(voidpf opaque, voidpf address)
 {
-    Z_Free(address);
+    if (opaque)
+        free(address);
+    else
+        Z_Free(address);
 }
 
 static void open_zip_file(file_t *file)
@@ -1033,11 +1183,14 @@ static void open_zip_file(file_t *file)
     zipstream_t *s;
     z_streamp z;
 
-    if (IS_UNIQUE(file)) {
+    // shared stream may have been set up with zone allocator, so
+    // async files always get a private one
+    if (IS_UNIQUE(file) || (file->mode & FS_FLAG_ASYNC) || fs_zipstream_busy) {
         s = FS_Malloc(sizeof(*s));
         memset(&s->stream, 0, sizeof(s->stream));
     } else {
         s = &fs_zipstream;
+        fs_zipstream_busy = true;
     }
 
     z = &s->stream;
@@ -1047,6 +1200,7 @@ static void open_zip_file(file_t *file)
     } else {
         z->zalloc = FS_zalloc;
         z->zfree = FS_zfree;
+        z->opaque = (file->mode & FS_FLAG_ASYNC) ? z : NULL;
         Q_assert(inflateInit2(z, -MAX_WBITS) == Z_OK);
     }
 
@@ -1057,22 +1211,26 @@ static void open_zip_file(file_t *file)
     file->zfp = s;
 }
 
-// only called for unique handles
 static void close_zip_file(file_t *file)
 {
     zipstream_t *s = file->zfp;
 
+    if (s == &fs_zipstream) {
+        fs_zipstream_busy = false;
+        return;
+    }
+
     inflateEnd(&s->stream);
     Z_Free(s);
-
-    fclose(file->fp);
 }
 
 static int read_zip_file(file_t *file, void *buf, size_t len)
 {
     zipstream_t *s = file->zfp;
     z_streamp z = &s->stream;
-    size_t block, result;
+    packfile_t *entry = file->entry;
+    int64_t result;
+    size_t block;
     int ret;
 
     Q_assert(file->position <= file->length);
@@ -1093,10 +1251,11 @@ static int read_zip_file(file_t *file, void *buf, size_t len)
 
             // fill in the temp buffer
             block = min(s->rest_in, ZIP_BUFSIZE);
-            result = fread(s->buffer, 1, block, file->fp);
+            result = Sys_ReadAt(file->fp, s->buffer, block,
+                                entry->filepos + entry->complen - s->rest_in);
             if (result != block) {
-                file->error = FS_ERR_READ(file->fp);
-                if (!result) {
+                file->error = result < 0 ? result : Q_ERR_UNEXPECTED_EOF;
+                if (result <= 0) {
                     break;
                 }
             }
@@ -1140,9 +1299,6 @@ static int seek_zip_file(file_t *file, int64_t offset, int whence)
         return offset;
 
     if (offset < file->position) {
-        if (os_fseek(file->fp, entry->filepos, SEEK_SET))
-            return Q_ERRNO;
-
         inflateReset(z);
 
         z->avail_in = z->avail_out = 0;
@@ -1171,52 +1327,28 @@ static int seek_zip_file(file_t *file, int64_t offset, int whence)
 #define entry_compmtd(entry)  0
 #endif
 
-// open a new file on the pakfile
+// open a new file on the pakfile. entries are read with positional reads
+// on the shared pack file, so any number of them can be open at once.
 static int64_t open_from_pack(file_t *file, pack_t *pack, packfile_t *entry)
 {
-    FILE *fp = NULL;
     int ret;
 
-    if (pack->type != FS_BUILTIN) {
-        if (IS_UNIQUE(file)) {
-            fp = fopen(pack->filename, "rb");
-            if (!fp) {
-                ret = Q_ERRNO;
-                goto fail1;
-            }
-        } else {
-            if (fs_non_uniq_open) {
-                ret = Q_ERR(EBUSY);
-                goto fail1;
-            }
-            fp = pack->fp;
-            clearerr(fp);
-        }
-    }
-
 #if USE_ZLIB
     if (pack->type == FS_ZIP) {
-        ret = check_header_coherency(fp, entry);
+        ret = check_header_coherency(pack->fp, entry);
         if (ret) {
-            goto fail2;
+            goto fail;
         }
     }
 #endif
 
     if ((file->mode & FS_FLAG_DEFLATE) && !entry_compmtd(entry)) {
         ret = Q_ERR_BAD_COMPRESSION;
-        goto fail2;
-    }
-
-    if (pack->type != FS_BUILTIN) {
-        if (os_fseek(fp, entry->filepos, SEEK_SET)) {
-            ret = Q_ERRNO;
-            goto fail2;
-        }
+        goto fail;
     }
 
     file->type = pack->type;
-    file->fp = fp;
+    file->fp = pack->fp;
     file->entry = entry;
     file->pack = pack;
     file->error = Q_ERR_SUCCESS;
@@ -1238,23 +1370,15 @@ static int64_t open_from_pack(file_t *file, pack_t *pack, packfile_t *entry)
     }
 #endif
 
-    if (IS_UNIQUE(file)) {
-        // reference source pak
-        pack_get(pack);
-    } else if (pack->type != FS_BUILTIN) {
-        fs_non_uniq_open = true;
-    }
+    // reference source pak
+    pack_get(pack);
 
     FS_DPrintf("%s: %s/%s: %"PRId64" bytes\n",
                __func__, pack->filename, pack->names + entry->nameofs, file->length);
 
     return file->length;
 
-fail2:
-    if (IS_UNIQUE(file)) {
-        fclose(fp);
-    }
-fail1:
+fail:
     FS_DPrintf("%s: %s/%s: %s\n", __func__, pack->filename, pack->names + entry->nameofs, Q_ErrorString(ret));
     return ret;
 }
@@ -1337,6 +1461,7 @@ static int64_t open_from_disk(file_t *file, const char *fullpath)
     file->fp = fp;
     file->error = Q_ERR_SUCCESS;
     file->length = info.size;
+    file->mtime = info.mtime;
 
 #if USE_ZLIB
     if (file->mode & FS_FLAG_GZIP) {
@@ -1360,6 +1485,119 @@ fail:
     return ret;
 }
 
+static void free_path_index(void)
+{
+    Z_Freep(&fs_index_hash);
+    Z_Freep(&fs_index_nodes);
+    fs_index_size = 0;
+
+    FS_FlushNegativeCache();
+}
+
+static void build_path_index(void)
+{
+    searchpath_t *search;
+    packfile_t *entry;
+    pathindex_t *node, **tail;
+    unsigned i, total;
+
+    free_path_index();
+
+    total = 0;
+    for (search = fs_searchpaths; search; search = search->next) {
+        if (search->pack) {
+            total += search->pack->num_files;
+        }
+    }
+    if (!total) {
+        return;
+    }
+
+    fs_index_size = Q_npot32(total / 3);
+    fs_index_hash = FS_Mallocz(fs_index_size * sizeof(fs_index_hash[0]));
+    fs_index_nodes = node = FS_Malloc(total * sizeof(node[0]));
+
+    // append to chain tails to keep entries in search order
+    for (search = fs_searchpaths; search; search = search->next) {
+        if (!search->pack) {
+            continue;
+        }
+        entry = search->pack->files;
+        for (i = 0; i < search->pack->num_files; i++, entry++, node++) {
+            tail = &fs_index_hash[FS_HashPath(search->pack->names + entry->nameofs, fs_index_size)];
+            while (*tail) {
+                tail = &(*tail)->next;
+            }
+            node->next = NULL;
+            node->search = search;
+            node->entry = entry;
+            *tail = node;
+        }
+    }
+
+    FS_DPrintf("%s: %u entries, %u slots\n", __func__, total, fs_index_size);
+}
+
+// returns first node at or after `node' that matches the path
+static pathindex_t *find_indexed(pathindex_t *node, const char *normalized, size_t namelen)
+{
+    for (; node; node = node->next) {
+        if (node->entry->namelen != namelen) {
+            continue;
+        }
+        FS_COUNT_STRCMP;
+        if (!FS_pathcmp(node->search->pack->names + node->entry->nameofs, normalized)) {
+            return node;
+        }
+    }
+
+    return NULL;
+}
+
+static negcache_t *negcache_slot(const searchpath_t *search, unsigned hash)
+{
+    hash ^= (uintptr_t)search >> 4;
+    return &fs_negcache[hash & (NEGCACHE_SIZE - 1)];
+}
+
+static bool negcache_lookup(searchpath_t *search, const char *normalized, unsigned hash)
+{
+    negcache_t *n = negcache_slot(search, hash);
+
+    return n->gen == fs_negcache_gen && n->hash == hash &&
+        n->search == search && !strcmp(n->path, normalized);
+}
+
+static void negcache_insert(searchpath_t *search, const char *normalized, size_t namelen, unsigned hash)
+{
+    negcache_t *n = negcache_slot(search, hash);
+
+    if (namelen >= sizeof(n->path)) {
+        return;
+    }
+
+    n->gen = fs_negcache_gen;
+    n->hash = hash;
+    n->search = search;
+    memcpy(n->path, normalized, namelen + 1);
+}
+
+/*
+================
+FS_FlushNegativeCache
+
+Must be called after files are created outside of FS_OpenFile/FS_CreatePath.
+================
+*/
+void FS_FlushNegativeCache(void)
+{
+    // generation 0 is never valid
+    if (!++fs_negcache_gen) {
+        memset(fs_negcache, 0, sizeof(fs_negcache));
+        fs_negcache_gen = 1;
+    }
+}
+
 // Finds the file in the search path.
 // Fills file_t and returns file length.
 // Used for streaming data out of either a pak file or a separate file.
@@ -1370,6 +1608,7 @@ static int64_t open_file_read(file_t *file, const char *normalized, size_t namel
     pack_t          *pak;
     unsigned        hash;
     packfile_t      *entry;
+    pathindex_t     *node;
     int64_t         ret;
     path_valid_t    valid;
 
@@ -1382,8 +1621,20 @@ static int64_t open_file_read(file_t *file, const char *normalized, size_t namel
 
     valid = PATH_NOT_CHECKED;
 
+    // find the first pack that has this file in merged index
+    node = NULL;
+    if (fs_index_hash && namelen < MAX_QPATH) {
+        node = find_indexed(fs_index_hash[hash & (fs_index_size - 1)], normalized, namelen);
+    }
+
 // search through the path, one element at a time
     for (search = fs_searchpaths; search; search = search->next) {
+        entry = NULL;
+        if (node && node->search == search) {
+            entry = node->entry;
+            node = find_indexed(node->next, normalized, namelen);
+        }
+
         if ((file->mode & search->mode & FS_PATH_MASK) == 0 ||
             (file->mode & search->mode & FS_DIR_MASK ) == 0) {
             continue;
@@ -1399,6 +1650,13 @@ static int64_t open_file_read(file_t *file, const char *normalized, size_t namel
                 continue;
             }
             pak = search->pack;
+            if (fs_index_hash) {
+                // merged index already knows if this pack has it
+                if (entry) {
+                    return open_from_pack(file, pak, entry);
+                }
+                continue;
+            }
             // look through all the pak file elements
             entry = pak->file_hash[hash & (pak->hash_size - 1)];
             for (; entry; entry = entry->hash_next) {
@@ -1424,6 +1682,11 @@ static int64_t open_file_read(file_t *file, const char *normalized, size_t namel
             if (valid == PATH_INVALID) {
                 continue;
             }
+            // known to be missing?
+            if (negcache_lookup(search, normalized, hash)) {
+                FS_COUNT_NEGCACHE;
+                continue;
+            }
             // check a file in the directory tree
             if (Q_concat(fullpath, sizeof(fullpath), search->filename,
                          "/", normalized) >= sizeof(fullpath)) {
@@ -1445,6 +1708,7 @@ static int64_t open_file_read(file_t *file, const char *normalized, size_t namel
                     return ret;
             }
 #endif
+            negcache_insert(search, normalized, namelen, hash);
         }
     }
 
@@ -1490,7 +1754,7 @@ static int64_t expand_open_file_read(file_t *file, const char *name)
 
 static int read_pak_file(file_t *file, void *buf, size_t len)
 {
-    size_t result;
+    int64_t result;
 
     Q_assert(file->position <= file->length);
 
@@ -1499,10 +1763,10 @@ static int read_pak_file(file_t *file, void *buf, size_t len)
         return 0;
     }
 
-    result = fread(buf, 1, len, file->fp);
+    result = Sys_ReadAt(file->fp, buf, len, file->entry->filepos + file->position);
     if (result != len) {
-        file->error = FS_ERR_READ(file->fp);
-        if (!result) {
+        file->error = result < 0 ? result : Q_ERR_UNEXPECTED_EOF;
+        if (result <= 0) {
             return file->error;
         }
     }
@@ -1547,16 +1811,12 @@ static int read_phys_file(file_t *file, void *buf, size_t len)
 FS_Read
 =================
 */
-int FS_Read(void *buf, size_t len, qhandle_t f)
+static int read_file(file_t *file, void *buf, size_t len)
 {
-    file_t *file = file_for_handle(f);
 #if USE_ZLIB
     int ret;
 #endif
 
-    if (!file)
-        return Q_ERR(EBADF);
-
     if ((file->mode & FS_MODE_MASK) != FS_MODE_READ)
         return Q_ERR(EBADF);
 
@@ -1593,6 +1853,16 @@ int FS_Read(void *buf, size_t len, qhandle_t f)
     }
 }
 
+int FS_Read(void *buf, size_t len, qhandle_t f)
+{
+    file_t *file = file_for_handle(f);
+
+    if (!file)
+        return Q_ERR(EBADF);
+
+    return read_file(file, buf, len);
+}
+
 int FS_ReadLine(qhandle_t f, char *buffer, size_t size)
 {
     file_t *file = file_for_handle(f);
@@ -1640,6 +1910,13 @@ int FS_Flush(qhandle_t f)
     if ((file->mode & FS_MODE_MASK) == FS_MODE_READ)
         return Q_ERR(EBADF);
 
+    // background thread is idle after this
+    if (file->async) {
+        ret = async_drain(file);
+        if (ret)
+            return ret;
+    }
+
     switch (file->type) {
     case FS_REAL:
         if (fflush(file->fp))
@@ -1658,6 +1935,189 @@ int FS_Flush(qhandle_t f)
     return ret;
 }
 
+static int write_file_data(file_t *file, const void *buf, size_t len)
+{
+    switch (file->type) {
+    case FS_REAL:
+        if (fwrite(buf, 1, len, file->fp) != len)
+            return Q_ERR_FAILURE;
+        break;
+#if USE_ZLIB
+    case FS_GZ:
+        if (gzwrite(file->zfp, buf, len) != len)
+            return Q_ERR_LIBRARY_ERROR;
+        break;
+#endif
+    default:
+        Q_assert(!"bad file type");
+    }
+
+    return Q_ERR_SUCCESS;
+}
+
+/*
+=============================================================================
+
+ASYNCHRONOUS WRITES
+
+Used for demo recording to keep disk I/O and gzip compression off the main
+thread. Queue depth is limited to a single buffer; if background thread
+falls behind, main thread waits for it. Write errors are reported by the
+next FS_Write that submits a buffer, or by FS_Flush/FS_CloseFile.
+
+=============================================================================
+*/
+
+static void *async_write_func(void *arg)
+{
+    file_t *file = arg;
+    asyncwrite_t *async = file->async;
+    const byte *data;
+    size_t len;
+    int ret;
+
+    pthread_mutex_lock(&async->lock);
+    while (1) {
+        while (!async->pending && !async->terminate)
+            pthread_cond_wait(&async->work_cond, &async->lock);
+
+        if (!async->pending)
+            break;
+
+        // buffer not being filled is owned by this thread until done
+        data = async->buffers[async->current ^ 1];
+        len = async->pending;
+        pthread_mutex_unlock(&async->lock);
+
+        // discard data after error
+        ret = async->error;
+        if (!ret)
+            ret = write_file_data(file, data, len);
+
+        pthread_mutex_lock(&async->lock);
+        async->error = ret;
+        async->pending = 0;
+        pthread_cond_signal(&async->done_cond);
+    }
+    pthread_mutex_unlock(&async->lock);
+
+    return NULL;
+}
+
+static void async_open(file_t *file, int64_t pos)
+{
+    asyncwrite_t *async = FS_Mallocz(sizeof(*async) + ASYNC_BUFSIZE * 2);
+
+    async->buffers[0] = (byte *)(async + 1);
+    async->buffers[1] = async->buffers[0] + ASYNC_BUFSIZE;
+    async->position = pos;
+
+    pthread_mutex_init(&async->lock, NULL);
+    pthread_cond_init(&async->work_cond, NULL);
+    pthread_cond_init(&async->done_cond, NULL);
+
+    file->async = async;
+    if (pthread_create(&async->thread, NULL, async_write_func, file)) {
+        // fall back to synchronous writes
+        Com_DPrintf("%s: couldn't create writer thread\n", __func__);
+        pthread_mutex_destroy(&async->lock);
+        pthread_cond_destroy(&async->work_cond);
+        pthread_cond_destroy(&async->done_cond);
+        Z_Free(async);
+        file->async = NULL;
+    }
+}
+
+// hands current buffer to background thread, waiting for the previous
+// one to be written first
+static int async_submit(file_t *file)
+{
+    asyncwrite_t *async = file->async;
+    int ret;
+
+    pthread_mutex_lock(&async->lock);
+    while (async->pending)
+        pthread_cond_wait(&async->done_cond, &async->lock);
+
+    ret = async->error;
+    if (!ret && async->cursize) {
+        async->pending = async->cursize;
+        async->current ^= 1;
+        async->cursize = 0;
+        pthread_cond_signal(&async->work_cond);
+    }
+    pthread_mutex_unlock(&async->lock);
+
+    return ret;
+}
+
+// submits remaining data and waits for background thread to become idle
+static int async_drain(file_t *file)
+{
+    asyncwrite_t *async = file->async;
+    int ret;
+
+    ret = async_submit(file);
+    if (ret)
+        return ret;
+
+    pthread_mutex_lock(&async->lock);
+    while (async->pending)
+        pthread_cond_wait(&async->done_cond, &async->lock);
+    ret = async->error;
+    pthread_mutex_unlock(&async->lock);
+
+    return ret;
+}
+
+static int async_close(file_t *file)
+{
+    asyncwrite_t *async = file->async;
+    int ret;
+
+    ret = async_drain(file);
+
+    pthread_mutex_lock(&async->lock);
+    async->terminate = true;
+    pthread_cond_signal(&async->work_cond);
+    pthread_mutex_unlock(&async->lock);
+
+    Q_assert(!pthread_join(async->thread, NULL));
+
+    pthread_mutex_destroy(&async->lock);
+    pthread_cond_destroy(&async->work_cond);
+    pthread_cond_destroy(&async->done_cond);
+    Z_Free(async);
+    file->async = NULL;
+
+    return ret;
+}
+
+static int async_write(file_t *file, const void *buf, size_t len)
+{
+    asyncwrite_t *async = file->async;
+    const byte *data = buf;
+    size_t rest = len;
+    int ret;
+
+    while (rest) {
+        if (async->cursize == ASYNC_BUFSIZE) {
+            ret = async_submit(file);
+            if (ret)
+                return ret;
+        }
+
+        size_t n = min(rest, ASYNC_BUFSIZE - async->cursize);
+        memcpy(async->buffers[async->current] + async->cursize, data, n);
+        async->cursize += n;
+        data += n;
+        rest -= n;
+    }
+
+    async->position += len;
+    return Q_ERR_SUCCESS;
+}
+
 /*
 =================
 FS_Write
@@ -1666,6 +2126,7 @@ FS_Write
 int FS_Write(const void *buf, size_t len, qhandle_t f)
 {
     file_t  *file = file_for_handle(f);
+    int     ret;
 
     if (!file)
         return Q_ERR(EBADF);
@@ -1683,23 +2144,14 @@ int FS_Write(const void *buf, size_t len, qhandle_t f)
     if (len == 0)
         return 0;
 
-    switch (file->type) {
-    case FS_REAL:
-        if (fwrite(buf, 1, len, file->fp) != len) {
-            file->error = Q_ERR_FAILURE;
-            return file->error;
-        }
-        break;
-#if USE_ZLIB
-    case FS_GZ:
-        if (gzwrite(file->zfp, buf, len) != len) {
-            file->error = Q_ERR_LIBRARY_ERROR;
-            return file->error;
-        }
-        break;
-#endif
-    default:
-        Q_assert(!"bad file type");
+    if (file->async)
+        ret = async_write(file, buf, len);
+    else
+        ret = write_file_data(file, buf, len);
+
+    if (ret) {
+        file->error = ret;
+        return ret;
     }
 
     return len;
@@ -1751,6 +2203,8 @@ int64_t FS_OpenFile(const char *name, qhandle_t *f, unsigned mode)
     }
 
     if (ret >= 0) {
+        if (mode & FS_FLAG_ASYNC && (mode & FS_MODE_MASK) != FS_MODE_READ)
+            async_open(file, ret);
         *f = handle;
     }
 
@@ -1894,18 +2348,170 @@ static void fuzz_data(const char *path, byte *buf, int size)
 }
 #endif
 
-/*
-============
-FS_LoadFile
+// returns direct view of uncompressed pack entry, or NULL if file
+// can't be mapped. view holds a reference to the pack.
+static const void *map_file(file_t *file)
+{
+    pack_t *pack = file->pack;
+    packfile_t *entry = file->entry;
+    mappedfile_t *m;
+    const void *view;
+    file_info_t info;
+    int i;
 
-opens non-unique file handle as an optimization
-a NULL buffer will just return the file length without loading
-============
-*/
-int FS_LoadFileEx(const char *path, void **buffer, unsigned flags, memtag_t tag)
+    if (!fs_mmap->integer)
+        return NULL;
+
+#if USE_TESTS
+    if (fs_fuzz_factor->value > 0)
+        return NULL;
+#endif
+
+    switch (file->type) {
+    case FS_BUILTIN:
+        view = (const void *)(intptr_t)entry->filepos;
+        break;
+    case FS_PAK:
+        // stored zip entries are opened as FS_PAK too
+        if (!pack->map && !pack->mapfailed) {
+            if (get_fp_info(pack->fp, &info) == Q_ERR_SUCCESS)
+                pack->map = Sys_MapFile(pack->fp, info.size);
+            if (pack->map) {
+                pack->mapsize = info.size;
+                FS_DPrintf("%s: mapped %s\n", __func__, pack->filename);
+            } else {
+                pack->mapfailed = true;
+            }
+        }
+        if (!pack->map || entry->filepos > pack->mapsize - file->length)
+            return NULL;
+        view = pack->map + entry->filepos;
+        break;
+    default:
+        return NULL;
+    }
+
+    // loaders read headers and samples through 16 and 32 bit pointers,
+    // so entries at odd offsets are copied instead
+    if ((uintptr_t)view & 3)
+        return NULL;
+
+    for (i = 0, m = fs_mapped; i < MAX_MAPPED_FILES; i++, m++) {
+        if (!m->data) {
+            m->data = view;
+            m->size = file->length;
+            m->pack = pack_get(pack);
+#if USE_DEBUG
+            fs_count_mapped++;
+            fs_bytes_mapped += file->length;
+#endif
+            return view;
+        }
+    }
+
+    return NULL;
+}
+
+#if USE_ZLIB
+static unsigned zipcache_hash(const pack_t *pack, const char *name)
+{
+    return (FS_HashPath(pack->filename, 0) * 31 + FS_HashPath(name, 0)) & (ZIPCACHE_HASH - 1);
+}
+
+static void zipcache_free(zipcache_t *z)
+{
+    zipcache_t **p;
+
+    for (p = &fs_zipcache_hash[z->hash]; *p != z; p = &(*p)->hash_next)
+        ;
+    *p = z->hash_next;
+
+    List_Remove(&z->entry);
+    fs_zipcache_size -= z->len;
+    Z_Free(z);
+}
+
+// evicts least recently used entries until `size' bytes are left
+static void zipcache_trim(size_t size)
+{
+    while (fs_zipcache_size > size)
+        zipcache_free(LIST_LAST(zipcache_t, &fs_zipcache_lru, entry));
+}
+
+static size_t zipcache_capacity(void)
+{
+    return Cvar_ClampInteger(fs_zipcache, 0, 1024) * 0x100000;
+}
+
+static void fs_zipcache_changed(cvar_t *self)
+{
+    zipcache_trim(zipcache_capacity());
+}
+
+static const zipcache_t *zipcache_find(const file_t *file)
+{
+    const pack_t *pack = file->pack;
+    const char *name = pack->names + file->entry->nameofs;
+    zipcache_t *z;
+
+    if (!pack->size)
+        return NULL;
+
+    for (z = fs_zipcache_hash[zipcache_hash(pack, name)]; z; z = z->hash_next) {
+        if (z->packsize == pack->size && z->packmtime == pack->mtime &&
+            z->len == file->length && !strcmp(z->name, name) &&
+            !strcmp(z->key, pack->filename)) {
+            // move to front
+            List_Remove(&z->entry);
+            List_Insert(&fs_zipcache_lru, &z->entry);
+            fs_zipcache_hits++;
+            return z;
+        }
+    }
+
+    fs_zipcache_misses++;
+    return NULL;
+}
+
+static void zipcache_add(const file_t *file, const void *data)
+{
+    const pack_t *pack = file->pack;
+    const char *name = pack->names + file->entry->nameofs;
+    size_t capacity = zipcache_capacity();
+    size_t pathlen, namelen;
+    zipcache_t *z;
+
+    // don't let single file flush most of the cache
+    if (!pack->size || file->length > capacity / 4)
+        return;
+
+    zipcache_trim(capacity - file->length);
+
+    pathlen = strlen(pack->filename) + 1;
+    namelen = file->entry->namelen + 1;
+    z = FS_Malloc(sizeof(*z) + pathlen + namelen + file->length);
+    z->hash = zipcache_hash(pack, name);
+    z->packsize = pack->size;
+    z->packmtime = pack->mtime;
+    z->len = file->length;
+    memcpy(z->key, pack->filename, pathlen);
+    memcpy(z->key + pathlen, name, namelen);
+    z->name = z->key + pathlen;
+    z->data = (byte *)z->key + pathlen + namelen;
+    memcpy(z->data, data, file->length);
+
+    z->hash_next = fs_zipcache_hash[z->hash];
+    fs_zipcache_hash[z->hash] = z;
+    List_Insert(&fs_zipcache_lru, &z->entry);
+    fs_zipcache_size += z->len;
+}
+#endif
+
+static int load_file(const char *path, void **buffer, unsigned flags, memtag_t tag, bool map)
 {
     file_t *file;
     qhandle_t f;
+    const void *view;
     byte *buf;
     int64_t len;
     int read;
@@ -1930,46 +2536,331 @@ int FS_LoadFileEx(const char *path, void **buffer, unsigned flags, memtag_t tag)
         return Q_ERR(EMFILE);
     }
 
-    file->mode = default_lookup_flags(flags) | FS_MODE_READ | FS_FLAG_LOADFILE;
+    file->mode = default_lookup_flags(flags) | FS_MODE_READ | FS_FLAG_LOADFILE;
+
+    // look for it in the filesystem or pack files
+    len = expand_open_file_read(file, path);
+    if (len < 0) {
+        return len;
+    }
+
+    // sanity check file size
+    if (len > MAX_LOADFILE) {
+        len = Q_ERR(EFBIG);
+        goto done;
+    }
+
+    // NULL buffer just checks for file existence
+    if (!buffer) {
+        goto done;
+    }
+
+    if (map) {
+        view = map_file(file);
+        if (view) {
+            *buffer = (void *)view;
+            goto done;
+        }
+#if USE_DEBUG
+        fs_count_copied++;
+#endif
+    }
+
+    // allocate chunk of memory, +1 for NUL
+    buf = Z_TagMalloc(len + 1, tag);
+
+#if USE_ZLIB
+    // deflated entries may have been inflated already
+    if (file->type == FS_ZIP && fs_zipcache->integer > 0) {
+        const zipcache_t *z = zipcache_find(file);
+        if (z) {
+            memcpy(buf, z->data, len);
+            goto loaded;
+        }
+    }
+#endif
+
+    // read entire file
+    read = FS_Read(buf, len, f);
+    if (read != len) {
+        len = read < 0 ? read : Q_ERR_UNEXPECTED_EOF;
+        Z_Free(buf);
+        goto done;
+    }
+
+#if USE_ZLIB
+    if (file->type == FS_ZIP && fs_zipcache->integer > 0) {
+        zipcache_add(file, buf);
+    }
+
+loaded:
+#endif
+
+#if USE_TESTS
+    fuzz_data(path, buf, len);
+#endif
+
+    *buffer = buf;
+    buf[len] = 0;
+
+done:
+    FS_CloseFile(f);
+    return len;
+}
+
+/*
+============
+FS_LoadFile
+
+opens non-unique file handle as an optimization
+a NULL buffer will just return the file length without loading
+============
+*/
+int FS_LoadFileEx(const char *path, void **buffer, unsigned flags, memtag_t tag)
+{
+    return load_file(path, buffer, flags, tag, false);
+}
+
+/*
+============
+FS_MapFile
+
+Returns read-only view of file contents. Uncompressed pack entries are
+served straight from pack mapping, anything else is loaded into memory.
+View must be released with FS_UnmapFile.
+============
+*/
+int FS_MapFile(const char *path, const void **buffer)
+{
+    Q_assert(buffer);
+    return load_file(path, (void **)buffer, 0, TAG_FILESYSTEM, true);
+}
+
+/*
+============
+FS_UnmapFile
+============
+*/
+void FS_UnmapFile(const void *buffer)
+{
+    mappedfile_t *m;
+    int i;
+
+    if (!buffer)
+        return;
+
+    for (i = 0, m = fs_mapped; i < MAX_MAPPED_FILES; i++, m++) {
+        if (m->data == buffer) {
+            pack_put(m->pack);
+            memset(m, 0, sizeof(*m));
+            return;
+        }
+    }
+
+    // loaded into memory
+    Z_Free((void *)buffer);
+}
+
+typedef struct {
+    file_t      file;       // private handle, not in fs_files
+    byte        *data;
+    int64_t     len;        // file length or error
+    bool        partial;    // short read is not an error
+    fs_loadcb_t cb;
+    void        *ctx;
+    char        path[1];
+} asyncload_t;
+
+typedef struct {
+    fs_loadreq_t    *reqs;
+    int             count;
+    int             remaining;
+    void            (*cb)(void *, fs_loadreq_t *, int);
+    void            *ctx;
+} asyncbatch_t;
+
+typedef struct {
+    asyncbatch_t    *batch;
+    fs_loadreq_t    *req;
+} asyncbatchitem_t;
+
+static int  fs_async_loads;     // queued, but not yet called back
+
+// runs on worker thread. pack entries are read with positional reads
+// and inflated with private stream, so no shared state is touched.
+static void async_load_work(void *arg)
+{
+    asyncload_t *load = arg;
+    int read;
+
+    read = read_file(&load->file, load->data, load->len);
+    if (read < 0 || (read < load->len && load->partial))
+        load->len = read;
+    else if (read != load->len)
+        load->len = Q_ERR_UNEXPECTED_EOF;
+}
+
+static void async_load_done(void *arg)
+{
+    asyncload_t *load = arg;
+
+    close_file(&load->file);
+    fs_async_loads--;
+
+    if (load->len < 0) {
+        Z_Freep(&load->data);
+    } else {
+#if USE_TESTS
+        fuzz_data(load->path, load->data, load->len);
+#endif
+        load->data[load->len] = 0;
+    }
+
+    load->cb(load->ctx, load->data, load->len);
+    Z_Free(load);
+}
+
+static int load_file_async(const char *path, int64_t maxlen, unsigned flags,
+                           memtag_t tag, fs_loadcb_t cb, void *ctx)
+{
+    asyncload_t *load;
+    int64_t len;
+
+    Q_assert(path);
+    Q_assert(cb);
+
+    if (!fs_searchpaths) {
+        return Q_ERR(EAGAIN); // not yet initialized
+    }
+
+    if (flags & FS_MODE_MASK) {
+        return Q_ERR(EINVAL);
+    }
+
+    load = FS_Mallocz(sizeof(*load) + strlen(path));
+    load->file.mode = default_lookup_flags(flags) | FS_MODE_READ | FS_FLAG_ASYNC;
 
     // look for it in the filesystem or pack files
-    len = expand_open_file_read(file, path);
+    len = expand_open_file_read(&load->file, path);
     if (len < 0) {
+        Z_Free(load);
         return len;
     }
 
     // sanity check file size
-    if (len > MAX_LOADFILE) {
-        len = Q_ERR(EFBIG);
-        goto done;
-    }
-
-    // NULL buffer just checks for file existence
-    if (!buffer) {
-        goto done;
+    if (maxlen) {
+        len = min(len, maxlen);
+    } else if (len > MAX_LOADFILE) {
+        close_file(&load->file);
+        Z_Free(load);
+        return Q_ERR(EFBIG);
     }
 
     // allocate chunk of memory, +1 for NUL
-    buf = Z_TagMalloc(len + 1, tag);
+    load->data = Z_TagMalloc(len + 1, tag);
+    load->len = len;
+    load->partial = maxlen;
+    load->cb = cb;
+    load->ctx = ctx;
+    strcpy(load->path, path);
+
+    asyncwork_t work = {
+        .work_cb = async_load_work,
+        .done_cb = async_load_done,
+        .cb_arg = load,
+    };
+    fs_async_loads++;
+    Com_QueueAsyncWork(&work);
+    return Q_ERR_SUCCESS;
+}
 
-    // read entire file
-    read = FS_Read(buf, len, f);
-    if (read != len) {
-        len = read < 0 ? read : Q_ERR_UNEXPECTED_EOF;
-        Z_Free(buf);
-        goto done;
-    }
+/*
+============
+FS_LoadFileAsync
 
-#if USE_TESTS
-    fuzz_data(path, buf, len);
-#endif
+Looks file up on the calling thread, then reads (and inflates) it on
+a worker thread. Callback is called from Com_CompleteAsyncWork with
+loaded data, or NULL and error code. Without worker threads it is called
+before this function returns. Returns error without calling callback if
+file can't be opened.
+============
+*/
+int FS_LoadFileAsync(const char *path, unsigned flags, memtag_t tag, fs_loadcb_t cb, void *ctx)
+{
+    return load_file_async(path, 0, flags, tag, cb, ctx);
+}
 
-    *buffer = buf;
-    buf[len] = 0;
+/*
+============
+FS_LoadFileHeadAsync
 
-done:
-    FS_CloseFile(f);
-    return len;
+Same as FS_LoadFileAsync, but reads at most maxlen leading bytes.
+FS_FLAG_GZIP can be used to read decompressed bytes of .gz files.
+============
+*/
+int FS_LoadFileHeadAsync(const char *path, size_t maxlen, unsigned flags,
+                         memtag_t tag, fs_loadcb_t cb, void *ctx)
+{
+    Q_assert(maxlen > 0 && maxlen <= MAX_LOADFILE);
+    return load_file_async(path, maxlen, flags, tag, cb, ctx);
+}
+
+static void async_batch_put(asyncbatch_t *batch)
+{
+    if (--batch->remaining)
+        return;
+
+    batch->cb(batch->ctx, batch->reqs, batch->count);
+    Z_Free(batch);
+}
+
+static void async_batch_done(void *ctx, void *data, int len)
+{
+    asyncbatchitem_t *item = ctx;
+
+    item->req->data = data;
+    item->req->len = len;
+    async_batch_put(item->batch);
+}
+
+/*
+============
+FS_LoadFilesAsync
+
+Loads a batch of files with FS_LoadFileAsync. Callback is called once
+after all requests have been filled in.
+============
+*/
+void FS_LoadFilesAsync(fs_loadreq_t *reqs, int count, unsigned flags, memtag_t tag,
+                       void (*cb)(void *, fs_loadreq_t *, int), void *ctx)
+{
+    asyncbatch_t *batch;
+    asyncbatchitem_t *items;
+    int i, ret;
+
+    Q_assert(count >= 0);
+    Q_assert(cb);
+
+    batch = FS_Malloc(sizeof(*batch) + count * sizeof(items[0]));
+    batch->reqs = reqs;
+    batch->count = count;
+    batch->remaining = count + 1;   // keep alive while queueing
+    batch->cb = cb;
+    batch->ctx = ctx;
+    items = (asyncbatchitem_t *)(batch + 1);
+
+    for (i = 0; i < count; i++) {
+        items[i].batch = batch;
+        items[i].req = &reqs[i];
+        reqs[i].data = NULL;
+        ret = FS_LoadFileAsync(reqs[i].path, flags, tag, async_batch_done, &items[i]);
+        if (ret < 0) {
+            reqs[i].len = ret;
+            batch->remaining--;
+        }
+    }
+
+    async_batch_put(batch);
 }
 
 static int write_and_close(const void *data, size_t len, qhandle_t f)
@@ -2064,6 +2955,7 @@ int FS_RenameFile(const char *from, const char *to)
     if (rename(frompath, topath))
         return Q_ERRNO;
 
+    FS_FlushNegativeCache();
     return Q_ERR_SUCCESS;
 }
 
@@ -2093,6 +2985,8 @@ int FS_FPrintf(qhandle_t f, const char *format, ...)
 
 static void pack_free(pack_t *pack)
 {
+    if (pack->map)
+        Sys_UnmapFile(pack->map, pack->mapsize);
     if (pack->fp)
         fclose(pack->fp);
     Z_Free(pack->names);
@@ -2137,6 +3031,11 @@ static pack_t *pack_alloc(FILE *fp, filetype_t type, const char *name,
     pack->files = FS_Malloc(num_files * sizeof(pack->files[0]));
     pack->hash_size = 0;
     pack->file_hash = NULL;
+    pack->map = NULL;
+    pack->mapsize = 0;
+    pack->mapfailed = false;
+    pack->size = 0;
+    pack->mtime = 0;
     pack->names = FS_Malloc(names_len);
     memcpy(pack->filename, name, len + 1);
 
@@ -2165,6 +3064,403 @@ static void pack_calc_hashes(pack_t *pack)
     }
 }
 
+/*
+=============================================================================
+
+PACK DIRECTORY CACHE
+
+Parsed pack directories are saved into a single binary file keyed by pack
+path, size and mtime. Cache is read once when search paths are set up and
+rewritten afterwards if any pack had to be parsed. Files are stored in
+native byte order; cache from another architecture just fails to match.
+
+=============================================================================
+*/
+
+#define PACKCACHE_IDENT     MakeLittleLong('P','K','C','I')
+#define PACKCACHE_VERSION   1
+
+#define MAX_CACHED_PACKS    4096
+
+typedef struct {
+    uint32_t    ident;
+    uint32_t    version;
+    uint32_t    num_packs;
+    uint32_t    file_size;  // sizeof(packcache_file_t)
+} packcache_header_t;
+
+// followed by path, files and names, each padded to 8 bytes
+typedef struct {
+    int64_t     size;
+    int64_t     mtime;
+    uint32_t    type;
+    uint32_t    num_files;
+    uint32_t    names_len;
+    uint32_t    path_len;   // including NUL
+} packcache_pack_t;
+
+typedef struct {
+    int64_t     filepos;
+    int64_t     filelen;
+    int64_t     complen;
+    uint32_t    nameofs;
+    uint32_t    hash;       // bucket in pack->file_hash
+    uint16_t    compmtd;
+    uint8_t     namelen;
+    uint8_t     coherent;
+} packcache_file_t;
+
+static byte                 *fs_packcache_data;     // raw cache file contents
+static packcache_pack_t     **fs_packcache_packs;
+static bool                 *fs_packcache_used;
+static unsigned             fs_packcache_count;
+static bool                 fs_packcache_loaded;
+static bool                 fs_packcache_dirty;
+
+static size_t pack_cache_len(const packcache_pack_t *rec)
+{
+    return sizeof(*rec) + Q_ALIGN(rec->path_len, 8) +
+        rec->num_files * sizeof(packcache_file_t) + Q_ALIGN(rec->names_len, 8);
+}
+
+static const char *pack_cache_rec_path(const packcache_pack_t *rec)
+{
+    return (const char *)(rec + 1);
+}
+
+static const packcache_file_t *pack_cache_rec_files(const packcache_pack_t *rec)
+{
+    return (const packcache_file_t *)((const byte *)(rec + 1) + Q_ALIGN(rec->path_len, 8));
+}
+
+static const char *pack_cache_rec_names(const packcache_pack_t *rec)
+{
+    return (const char *)(pack_cache_rec_files(rec) + rec->num_files);
+}
+
+static bool pack_cache_path(char *buf, size_t size)
+{
+    const char *dir = sys_homedir->string[0] ? sys_homedir->string : sys_basedir->string;
+
+    return Q_concat(buf, size, dir, "/" BASEGAME "/" COM_PACKCACHE_NAME) < size;
+}
+
+static void free_pack_cache(void)
+{
+    Z_Freep(&fs_packcache_data);
+    Z_Freep(&fs_packcache_packs);
+    Z_Freep(&fs_packcache_used);
+    fs_packcache_count = 0;
+    fs_packcache_loaded = false;
+    fs_packcache_dirty = false;
+}
+
+static void load_pack_cache(void)
+{
+    char path[MAX_OSPATH];
+    const packcache_header_t *header;
+    packcache_pack_t *rec;
+    file_info_t info;
+    size_t ofs, len;
+    unsigned i;
+    FILE *fp;
+
+    fs_packcache_loaded = true;
+
+    if (!fs_packcache->integer)
+        return;
+    if (!pack_cache_path(path, sizeof(path)))
+        return;
+
+    fp = fopen(path, "rb");
+    if (!fp)
+        return;
+
+    if (get_fp_info(fp, &info) || info.size < sizeof(*header) || info.size > MAX_LOADFILE) {
+        fclose(fp);
+        return;
+    }
+
+    // read everything at once
+    fs_packcache_data = FS_Malloc(info.size);
+    if (!fread(fs_packcache_data, info.size, 1, fp)) {
+        fclose(fp);
+        goto fail;
+    }
+    fclose(fp);
+
+    header = (const packcache_header_t *)fs_packcache_data;
+    if (header->ident != PACKCACHE_IDENT || header->version != PACKCACHE_VERSION ||
+        header->file_size != sizeof(packcache_file_t) || header->num_packs > MAX_CACHED_PACKS)
+        goto fail;
+
+    fs_packcache_packs = FS_Malloc(header->num_packs * sizeof(fs_packcache_packs[0]));
+    fs_packcache_used = FS_Mallocz(header->num_packs * sizeof(fs_packcache_used[0]));
+
+    // validate record boundaries, contents are checked on use
+    ofs = sizeof(*header);
+    for (i = 0; i < header->num_packs; i++) {
+        if (info.size - ofs < sizeof(*rec))
+            goto fail;
+        rec = (packcache_pack_t *)(fs_packcache_data + ofs);
+        if (rec->num_files < 1 || rec->num_files > MAX_FILES_IN_PACK)
+            goto fail;
+        if (rec->names_len > rec->num_files * MAX_QPATH)
+            goto fail;
+        if (rec->path_len < 2 || rec->path_len > MAX_OSPATH)
+            goto fail;
+        len = pack_cache_len(rec);
+        if (len > info.size - ofs)
+            goto fail;
+        if (pack_cache_rec_path(rec)[rec->path_len - 1])
+            goto fail;
+        fs_packcache_packs[i] = rec;
+        ofs += len;
+    }
+
+    fs_packcache_count = header->num_packs;
+    FS_DPrintf("%s: %u packs\n", __func__, fs_packcache_count);
+    return;
+
+fail:
+    Com_DPrintf("Ignoring bad pack cache %s\n", path);
+    free_pack_cache();
+    fs_packcache_loaded = true;
+}
+
+// fills pack directory from cache. returns NULL if pack isn't cached
+// or cached data is inconsistent.
+static pack_t *load_cached_pack(FILE *fp, filetype_t type, const char *packfile)
+{
+    const packcache_pack_t *rec;
+    const packcache_file_t *src;
+    file_info_t info;
+    packfile_t *file;
+    pack_t *pack;
+    unsigned i;
+
+    if (!fs_packcache_loaded)
+        load_pack_cache();
+
+    if (get_fp_info(fp, &info))
+        return NULL;
+
+    for (i = 0; i < fs_packcache_count; i++) {
+        rec = fs_packcache_packs[i];
+        if (!fs_packcache_used[i] && rec->type == type &&
+            rec->size == info.size && rec->mtime == info.mtime &&
+            !strcmp(pack_cache_rec_path(rec), packfile))
+            break;
+    }
+    if (i == fs_packcache_count)
+        return NULL;
+
+    fs_packcache_used[i] = true;
+
+    pack = pack_alloc(fp, type, packfile, rec->num_files, rec->names_len);
+    pack->size = info.size;
+    pack->mtime = info.mtime;
+    memcpy(pack->names, pack_cache_rec_names(rec), rec->names_len);
+
+    pack->hash_size = Q_npot32(pack->num_files / 3);
+    pack->file_hash = FS_Mallocz(pack->hash_size * sizeof(pack->file_hash[0]));
+
+    // names are already normalized and hashed
+    src = pack_cache_rec_files(rec);
+    for (i = 0, file = pack->files; i < pack->num_files; i++, file++, src++) {
+        if (src->nameofs >= rec->names_len || src->namelen >= rec->names_len - src->nameofs ||
+            pack->names[src->nameofs + src->namelen] || src->hash >= pack->hash_size)
+            goto fail;
+        // data must be within pack, deflated entries take complen bytes
+        if (src->filepos < 0 || src->filelen < 0 || src->complen < 0 || src->filepos > rec->size ||
+            (src->compmtd ? src->complen : src->filelen) > rec->size - src->filepos)
+            goto fail;
+        file->filepos = src->filepos;
+        file->filelen = src->filelen;
+#if USE_ZLIB
+        file->complen = src->complen;
+        file->compmtd = src->compmtd;
+        file->coherent = src->coherent;
+#endif
+        file->namelen = src->namelen;
+        file->nameofs = src->nameofs;
+        file->hash_next = pack->file_hash[src->hash];
+        pack->file_hash[src->hash] = file;
+    }
+
+    FS_DPrintf("%s: %u files, %u hash\n",
+               packfile, pack->num_files, pack->hash_size);
+    return pack;
+
+fail:
+    Com_DPrintf("Bad pack cache entry for %s\n", packfile);
+    pack->fp = NULL;    // caller owns it
+    pack_free(pack);
+    return NULL;
+}
+
+// remembers freshly parsed pack so that cache is rewritten
+static void cache_parsed_pack(pack_t *pack)
+{
+    file_info_t info;
+
+    // also used as identity for inflated entries cache
+    if (get_fp_info(pack->fp, &info))
+        return;
+
+    pack->size = info.size;
+    pack->mtime = info.mtime;
+    if (fs_packcache->integer)
+        fs_packcache_dirty = true;
+}
+
+static bool write_padded(FILE *fp, const void *data, size_t len)
+{
+    static const byte pad[8];
+    size_t padlen = Q_ALIGN(len, 8) - len;
+
+    return fwrite(data, 1, len, fp) == len && fwrite(pad, 1, padlen, fp) == padlen;
+}
+
+static bool write_cache_rec(FILE *fp, const packcache_pack_t *rec, const char *path,
+                            const packcache_file_t *files, const char *names)
+{
+    return fwrite(rec, sizeof(*rec), 1, fp) &&
+        write_padded(fp, path, rec->path_len) &&
+        fwrite(files, sizeof(files[0]), rec->num_files, fp) == rec->num_files &&
+        write_padded(fp, names, rec->names_len);
+}
+
+static bool write_pack_rec(FILE *fp, const pack_t *pack)
+{
+    packcache_pack_t rec;
+    packcache_file_t *files, *dst;
+    const packfile_t *file;
+    unsigned i;
+    bool ret;
+
+    rec.size = pack->size;
+    rec.mtime = pack->mtime;
+    rec.type = pack->type;
+    rec.num_files = pack->num_files;
+    rec.names_len = 0;
+    rec.path_len = strlen(pack->filename) + 1;
+
+    files = FS_AllocTempMem(pack->num_files * sizeof(files[0]));
+    for (i = 0, file = pack->files, dst = files; i < pack->num_files; i++, file++, dst++) {
+        memset(dst, 0, sizeof(*dst));
+        dst->filepos = file->filepos;
+        dst->filelen = file->filelen;
+#if USE_ZLIB
+        dst->complen = file->complen;
+        dst->compmtd = file->compmtd;
+        dst->coherent = file->coherent;
+#else
+        dst->complen = file->filelen;
+        dst->coherent = true;
+#endif
+        dst->namelen = file->namelen;
+        dst->nameofs = file->nameofs;
+        dst->hash = Com_HashString(pack->names + file->nameofs, pack->hash_size);
+        rec.names_len = max(rec.names_len, file->nameofs + file->namelen + 1);
+    }
+
+    ret = write_cache_rec(fp, &rec, pack->filename, files, pack->names);
+    FS_FreeTempMem(files);
+    return ret;
+}
+
+// keeps cached packs that weren't loaded this time but still exist unchanged
+static bool keep_cached_pack(unsigned index)
+{
+    const packcache_pack_t *rec = fs_packcache_packs[index];
+    file_info_t info;
+
+    if (fs_packcache_used[index])
+        return false;
+    if (get_path_info(pack_cache_rec_path(rec), &info))
+        return false;
+    return info.size == rec->size && info.mtime == rec->mtime;
+}
+
+// called after search paths are set up
+static void save_pack_cache(void)
+{
+    char path[MAX_OSPATH], temp[MAX_OSPATH];
+    packcache_header_t header;
+    const packcache_pack_t *rec;
+    searchpath_t *search;
+    bool *keep = NULL;
+    unsigned i;
+    FILE *fp;
+    bool ok;
+
+    if (!fs_packcache_dirty || !fs_packcache->integer)
+        goto done;
+    if (!pack_cache_path(path, sizeof(path)) || FS_CreatePath(path))
+        goto done;
+    if (Q_concat(temp, sizeof(temp), path, ".tmp") >= sizeof(temp))
+        goto done;
+
+    header.ident = PACKCACHE_IDENT;
+    header.version = PACKCACHE_VERSION;
+    header.num_packs = 0;
+    header.file_size = sizeof(packcache_file_t);
+
+    for (search = fs_searchpaths; search; search = search->next)
+        if (search->pack && search->pack->size)
+            header.num_packs++;
+
+    if (fs_packcache_count) {
+        keep = FS_AllocTempMem(fs_packcache_count * sizeof(keep[0]));
+        for (i = 0; i < fs_packcache_count; i++) {
+            keep[i] = keep_cached_pack(i);
+            header.num_packs += keep[i];
+        }
+    }
+
+    header.num_packs = min(header.num_packs, MAX_CACHED_PACKS);
+
+    // write to temporary file, so that crash or another instance never
+    // sees partially written cache
+    fp = fopen(temp, "wb");
+    if (!fp)
+        goto done;
+
+    ok = fwrite(&header, sizeof(header), 1, fp);
+    i = 0;
+    for (search = fs_searchpaths; ok && search; search = search->next) {
+        if (search->pack && search->pack->size && i++ < header.num_packs)
+            ok = write_pack_rec(fp, search->pack);
+    }
+    for (unsigned j = 0; ok && j < fs_packcache_count; j++) {
+        rec = fs_packcache_packs[j];
+        if (keep[j] && i++ < header.num_packs)
+            ok = write_cache_rec(fp, rec, pack_cache_rec_path(rec),
+                                 pack_cache_rec_files(rec), pack_cache_rec_names(rec));
+    }
+
+    if (fclose(fp) || !ok) {
+        Com_WPrintf("Couldn't write %s\n", temp);
+        remove(temp);
+        goto done;
+    }
+
+    // rename() doesn't replace existing file on windows
+    if (rename(temp, path) && (remove(path) || rename(temp, path))) {
+        Com_WPrintf("Couldn't rename %s to %s\n", temp, path);
+        remove(temp);
+        goto done;
+    }
+
+    FS_DPrintf("%s: %u packs\n", __func__, header.num_packs);
+
+done:
+    if (keep)
+        FS_FreeTempMem(keep);
+    free_pack_cache();
+}
+
 // Loads the header and directory, adding the files at the beginning
 // of the list so they override previous pack files.
 static pack_t *load_pak_file(const char *packfile)
@@ -2185,6 +3481,11 @@ static pack_t *load_pak_file(const char *packfile)
         return NULL;
     }
 
+    pack = load_cached_pack(fp, FS_PAK, packfile);
+    if (pack) {
+        return pack;
+    }
+
     if (!fread(&header, sizeof(header), 1, fp)) {
         Com_SetLastError("Reading header failed");
         goto fail1;
@@ -2263,6 +3564,7 @@ static pack_t *load_pak_file(const char *packfile)
     }
 
     pack_calc_hashes(pack);
+    cache_parsed_pack(pack);
 
     FS_DPrintf("%s: %u files, %u hash\n",
                packfile, pack->num_files, pack->hash_size);
@@ -2534,6 +3836,11 @@ static pack_t *load_zip_file(const char *packfile)
         return NULL;
     }
 
+    pack = load_cached_pack(fp, FS_ZIP, packfile);
+    if (pack) {
+        return pack;
+    }
+
     header_pos = search_central_header(fp);
     if (!header_pos) {
         Com_SetLastError("No central header found");
@@ -2642,6 +3949,7 @@ static pack_t *load_zip_file(const char *packfile)
     pack->names = Z_Realloc(pack->names, names_len);
 
     pack_calc_hashes(pack);
+    cache_parsed_pack(pack);
 
     FS_DPrintf("%s: %u files, %u skipped, %u hash%s\n",
                packfile, pack->num_files, (int)(num_files_cd - num_files),
@@ -3458,6 +4766,26 @@ static void FS_Stats_f(void)
     Com_Printf("Total path comparisons: %u\n", fs_count_strcmp);
     Com_Printf("Total calls to open_from_disk: %u\n", fs_count_open);
     Com_Printf("Total mixed-case reopens: %u\n", fs_count_strlwr);
+    Com_Printf("Total negative cache hits: %u\n", fs_count_negcache);
+    Com_Printf("Path index: %u slots\n", fs_index_size);
+#if USE_ZLIB
+    Com_Printf("Inflated cache: %zu bytes, %u hits, %u misses\n",
+               fs_zipcache_size, fs_zipcache_hits, fs_zipcache_misses);
+#endif
+    Com_Printf("Total files mapped: %u (%"PRIu64" bytes), copied: %u\n",
+               fs_count_mapped, fs_bytes_mapped, fs_count_copied);
+
+    for (i = len = 0; i < MAX_MAPPED_FILES; i++) {
+        if (fs_mapped[i].data) {
+            len++;
+        }
+    }
+    Com_Printf("Mapped views in use: %d\n", len);
+    for (path = fs_searchpaths; path; path = path->next) {
+        if ((pack = path->pack) && pack->map) {
+            Com_Printf("Mapped %s (%"PRId64" bytes)\n", pack->filename, pack->mapsize);
+        }
+    }
 
     if (!totalHashSize) {
         Com_Printf("No stats to display\n");
@@ -3635,6 +4963,8 @@ static void free_all_paths(void)
 {
     searchpath_t *path, *next;
 
+    free_path_index();
+
     for (path = fs_searchpaths; path; path = next) {
         next = path->next;
         free_search_path(path);
@@ -3647,6 +4977,8 @@ static void free_game_paths(void)
 {
     searchpath_t *path, *next;
 
+    free_path_index();
+
     for (path = fs_searchpaths; path != fs_base_searchpaths; path = next) {
         next = path->next;
         free_search_path(path);
@@ -3729,6 +5061,9 @@ static void setup_game_paths(void)
         }
     }
 
+    build_path_index();
+    save_pack_cache();
+
     // this var is set for compatibility with server browsers, etc
     Cvar_FullSet("gamedir", fs_game->string, CVAR_ROM | CVAR_SERVERINFO, FROM_CODE);
 
@@ -3825,6 +5160,13 @@ void FS_Shutdown(void)
         return;
     }
 
+    // let pending async loads finish and call back
+    while (fs_async_loads) {
+        Com_CompleteAsyncWork();
+        if (fs_async_loads)
+            Sys_Sleep(1);
+    }
+
     // close file handles
     for (i = 0, file = fs_files; i < fs_num_files; i++, file++) {
         if (file->type != FS_FREE) {
@@ -3843,6 +5185,7 @@ void FS_Shutdown(void)
 
 #if USE_ZLIB
     inflateEnd(&fs_zipstream.stream);
+    zipcache_trim(0);
 #endif
 
     Z_LeakTest(TAG_FILESYSTEM);
@@ -4020,6 +5363,12 @@ void FS_Init(void)
     Cmd_Register(c_fs);
 
     fs_autoexec = Cvar_Get("fs_autoexec", "1", 0);
+    fs_mmap = Cvar_Get("fs_mmap", "1", 0);
+    fs_packcache = Cvar_Get("fs_packcache", "1", 0);
+#if USE_ZLIB
+    fs_zipcache = Cvar_Get("fs_zipcache", "16", 0);
+    fs_zipcache->changed = fs_zipcache_changed;
+#endif
 
 #if USE_DEBUG
     fs_debug = Cvar_Get("fs_debug", "0", 0);
@@ -17,6 +17,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 */
 
 #include "shared/shared.h"
+#include "common/async.h"
 #include "common/bsp.h"
 #include "common/cmd.h"
 #include "common/common.h"
@@ -893,6 +894,169 @@ static void UTF8_Test_f(void)
 }
 #endif
 
+#define JOBTEST_COUNT   64
+
+typedef struct {
+    bool    first[JOBTEST_COUNT];
+    bool    second[JOBTEST_COUNT];
+    bool    order[JOBTEST_COUNT];
+    int     hits[JOBTEST_COUNT * 4];
+    bool    worked;
+    bool    done;
+} jobtest_t;
+
+static jobtest_t    jobtest;
+
+static void jobtest_first(void *arg)
+{
+    jobtest.first[(bool *)arg - jobtest.first] = true;
+}
+
+static void jobtest_second(void *arg)
+{
+    int i, n = (bool *)arg - jobtest.second;
+
+    // every job of the first group must be done by now
+    jobtest.order[n] = true;
+    for (i = 0; i < JOBTEST_COUNT; i++)
+        if (!jobtest.first[i])
+            jobtest.order[n] = false;
+
+    jobtest.second[n] = true;
+}
+
+static void jobtest_range(void *arg, int index)
+{
+    jobtest.hits[index]++;
+}
+
+static void jobtest_work(void *arg)
+{
+    jobtest.worked = true;
+}
+
+static void jobtest_done(void *arg)
+{
+    jobtest.done = jobtest.worked;
+}
+
+static void Com_JobTest_f(void)
+{
+    jobgroup_t *a, *b;
+    asyncwork_t work = {
+        .work_cb = jobtest_work,
+        .done_cb = jobtest_done,
+    };
+    int i, errors, passes;
+
+    passes = Q_clip(Q_atoi(Cmd_Argv(1)), 1, 1000);
+
+    errors = 0;
+    for (int p = 0; p < passes; p++) {
+        memset(&jobtest, 0, sizeof(jobtest));
+
+        // create dependent group first, so that its jobs could be picked up
+        // before the ones it depends on if dependency didn't hold them
+        a = Com_CreateJobGroup();
+        b = Com_CreateJobGroup();
+        Com_AddJobDependency(b, a);
+        for (i = 0; i < JOBTEST_COUNT; i++)
+            Com_AddJob(b, jobtest_second, &jobtest.second[i]);
+        Com_CloseJobGroup(b);
+        for (i = 0; i < JOBTEST_COUNT; i++)
+            Com_AddJob(a, jobtest_first, &jobtest.first[i]);
+        Com_WaitJobGroup(b);
+        Com_WaitJobGroup(a);
+
+        for (i = 0; i < JOBTEST_COUNT; i++) {
+            if (!jobtest.second[i]) {
+                Com_EPrintf("Job %d of dependent group didn't run\n", i);
+                errors++;
+            } else if (!jobtest.order[i]) {
+                Com_EPrintf("Job %d of dependent group ran too early\n", i);
+                errors++;
+            }
+        }
+
+        Com_ParallelFor(q_countof(jobtest.hits), jobtest_range, NULL);
+        for (i = 0; i < q_countof(jobtest.hits); i++) {
+            if (jobtest.hits[i] != 1) {
+                Com_EPrintf("Com_ParallelFor index %d ran %d times\n", i, jobtest.hits[i]);
+                errors++;
+            }
+        }
+
+        Com_QueueAsyncWork(&work);
+        for (i = 0; i < 1000 && !jobtest.done; i++) {
+            Com_CompleteAsyncWork();
+            if (!jobtest.done)
+                Sys_Sleep(1);
+        }
+        if (!jobtest.done) {
+            Com_EPrintf("Async work didn't complete\n");
+            errors++;
+        }
+    }
+
+    Com_Printf("%d failures, %d passes tested\n", errors, passes);
+}
+
+#define MAX_LOADTEST    32
+
+static bool loadtest_done;
+
+static void loadtest_cb(void *ctx, fs_loadreq_t *reqs, int count)
+{
+    loadtest_done = true;
+}
+
+// compares files loaded with FS_LoadFilesAsync against synchronous loads
+static void Com_AsyncLoadTest_f(void)
+{
+    fs_loadreq_t reqs[MAX_LOADTEST];
+    int i, count, len, errors;
+    void *data;
+
+    if (Cmd_Argc() < 2) {
+        Com_Printf("Usage: %s <file> [...]\n", Cmd_Argv(0));
+        return;
+    }
+
+    count = min(Cmd_Argc() - 1, MAX_LOADTEST);
+    for (i = 0; i < count; i++)
+        reqs[i].path = Cmd_Argv(i + 1);
+
+    loadtest_done = false;
+    FS_LoadFilesAsync(reqs, count, 0, TAG_FILESYSTEM, loadtest_cb, NULL);
+    for (i = 0; i < 5000 && !loadtest_done; i++) {
+        Com_CompleteAsyncWork();
+        if (!loadtest_done)
+            Sys_Sleep(1);
+    }
+    if (!loadtest_done) {
+        // can't free requests still in flight
+        Com_EPrintf("Async loads didn't complete\n");
+        return;
+    }
+
+    errors = 0;
+    for (i = 0; i < count; i++) {
+        data = NULL;
+        len = FS_LoadFile(reqs[i].path, &data);
+        if (len != reqs[i].len) {
+            Com_EPrintf("%s: async length %d, expected %d\n", reqs[i].path, reqs[i].len, len);
+            errors++;
+        } else if (len >= 0 && memcmp(data, reqs[i].data, len + 1)) {
+            Com_EPrintf("%s: async data mismatch\n", reqs[i].path);
+            errors++;
+        }
+        FS_FreeFile(data);
+        Z_Free(reqs[i].data);
+    }
+
+    Com_Printf("%d failures, %d files tested\n", errors, count);
+}
+
 static const cmdreg_t c_test[] = {
     { "error", Com_Error_f },
     { "errordrop", Com_ErrorDrop_f },
@@ -919,6 +1083,8 @@ static const cmdreg_t c_test[] = {
     { "extcmptest", Com_ExtCmpTest_f },
     { "nextpathtest", Com_NextPathTest_f },
     { "extract", Com_Extract_f },
+    { "jobtest", Com_JobTest_f },
+    { "asyncloadtest", Com_AsyncLoadTest_f },
     { NULL }
 };
 
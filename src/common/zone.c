@@ -20,24 +20,64 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include "shared/list.h"
 #include "common/common.h"
 #include "common/zone.h"
+#include "common/cvar.h"
+#include "common/files.h"
+#include "shared/atomic.h"
+#include "system/system.h"
 
 #if USE_MEMORY_TRACES
 #define MAX_TRACE_SIZE 32
-#include "system/system.h"
 #endif
 
-#define Z_MAGIC     0x1d0d
+#define Z_MAGIC         0x1d0d  // allocated with malloc
+#define Z_MAGIC_SLAB    0x1d0e  // carved from size class slab page
+#define Z_MAGIC_ARENA   0x1d0f  // bumped from tag arena chunk
+#define Z_SAMPLED       0x8000  // recorded by allocation profiler
+
+#define Z_KIND(z)       ((z)->magic & ~Z_SAMPLED)
+
+#define Z_SLAB_MAX      256     // largest size served from slabs
+#define Z_SLAB_PAGE     0x10000
+#define Z_ARENA_CHUNK   0x10000
+#define Z_ARENA_ALIGN   16
+
+typedef struct zchunk_s zchunk_t;
 
 typedef struct {
     uint16_t        magic;
     uint16_t        tag;        // for group free
     size_t          size;
-    list_t          entry;
+    union {
+        list_t      entry;      // heap and slab blocks
+        zchunk_t    *chunk;     // arena blocks
+    };
 #if USE_MEMORY_TRACES
     void            *trace[MAX_TRACE_SIZE];
 #endif
 } zhead_t;
 
+struct zchunk_s {
+    list_t      entry;
+    size_t      size;       // usable bytes
+    size_t      used;       // bump offset
+    size_t      count;      // live blocks
+};
+
+#define Z_CHUNK_HEAD    Q_ALIGN(sizeof(zchunk_t), Z_ARENA_ALIGN)
+#define Z_CHUNK_DATA(c) ((byte *)(c) + Z_CHUNK_HEAD)
+
+typedef struct {
+    list_t      chunks;     // first chunk is the one being bumped
+    size_t      numchunks;
+    size_t      bytes;
+} zarena_t;
+
+typedef struct {
+    zhead_t     *free;      // linked through block data
+    size_t      count;      // blocks in use
+    size_t      total;      // blocks carved from pages
+} zslab_t;
+
 typedef struct {
     zhead_t     z;
     char        data[2];
@@ -50,6 +90,40 @@ typedef struct {
 
 static list_t       z_chain;
 static zstats_t     z_stats[TAG_MAX];
+static uint64_t     z_allocs;   // total number of heap (re)allocations
+
+static const uint16_t z_slabsizes[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+// maps (size + 15) / 16 to index into z_slabsizes
+static const uint8_t z_slabclass[Z_SLAB_MAX / 16 + 1] = {
+    0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7
+};
+
+static zslab_t      z_slabs[q_countof(z_slabsizes)];
+static size_t       z_slabpages;
+
+// objects of these tags live and die together, so they are bumped from
+// per-tag arenas instead and Z_FreeTags drops the chunks wholesale
+static const bool z_arenatags[TAG_MAX] = {
+    [TAG_NAV]   = true,
+    [TAG_MAPDB] = true,
+};
+
+static zarena_t     z_arenas[TAG_MAX];
+
+#define Z_FRAME_SIZE    0x100000    // per thread
+#define Z_FRAME_ALIGN   16
+
+typedef struct {
+    byte        *base;
+    size_t      used;
+    size_t      peak;       // high water mark of this thread
+} zframe_t;
+
+static q_thread_local zframe_t z_frame;
+
+static size_t       z_framelast;    // main thread high water mark last frame
+static atomic_int   z_framepeak;    // high water mark of all threads
 
 #define S(d) \
     { .z = { .magic = Z_MAGIC, .tag = TAG_STATIC, .size = sizeof(zstatic_t) }, .data = d }
@@ -72,10 +146,14 @@ static const char *const z_tagnames[TAG_MAX] = {
     "server",
     "mvd",
     "sound",
-    "cmodel"
+    "cmodel",
+    "nav",
+    "mapdb"
 };
 
 #define TAG_INDEX(tag)  ((tag) < TAG_MAX ? (tag) : TAG_FREE)
+#define TAG_ARENA(tag)  ((tag) < TAG_MAX && z_arenatags[tag])
+#define SLAB_CLASS(size)    z_slabclass[((size) + 15) >> 4]
 
 static inline void Z_CountFree(const zhead_t *z)
 {
@@ -92,18 +170,25 @@ static inline void Z_CountAlloc(const zhead_t *z)
 }
 
 #define Z_Validate(z) \
-    Q_assert((z)->magic == Z_MAGIC && (z)->tag != TAG_FREE)
+    Q_assert((Z_KIND(z) == Z_MAGIC || Z_KIND(z) == Z_MAGIC_SLAB || \
+              Z_KIND(z) == Z_MAGIC_ARENA) && (z)->tag != TAG_FREE)
 
 void Z_LeakTest(memtag_t tag)
 {
     zhead_t *z;
     size_t numLeaks = 0, numBytes = 0;
 
-    LIST_FOR_EACH(zhead_t, z, &z_chain, entry) {
-        Z_Validate(z);
-        if (z->tag == tag || (tag == TAG_FREE && z->tag >= TAG_MAX)) {
-            numLeaks++;
-            numBytes += z->size;
+    if (TAG_ARENA(tag)) {
+        // arena blocks are not chained
+        numLeaks = z_stats[tag].count;
+        numBytes = z_stats[tag].bytes;
+    } else {
+        LIST_FOR_EACH(zhead_t, z, &z_chain, entry) {
+            Z_Validate(z);
+            if (z->tag == tag || (tag == TAG_FREE && z->tag >= TAG_MAX)) {
+                numLeaks++;
+                numBytes += z->size;
+            }
         }
     }
 
@@ -116,6 +201,335 @@ void Z_LeakTest(memtag_t tag)
     }
 }
 
+/*
+========================
+Z_SlabAlloc
+
+Returns block from size class free list, carving a new page if it is empty.
+Pages are kept around for reuse and never given back.
+========================
+*/
+static zhead_t *Z_SlabAlloc(size_t size)
+{
+    zslab_t *s = &z_slabs[SLAB_CLASS(size)];
+    zhead_t *z;
+
+    if (!s->free) {
+        size_t blocksize = sizeof(*z) + z_slabsizes[s - z_slabs];
+        size_t i, count = Z_SLAB_PAGE / blocksize;
+        byte *page = malloc(Z_SLAB_PAGE);
+
+        if (!page) {
+            Com_Error(ERR_FATAL, "%s: couldn't allocate %d bytes", __func__, Z_SLAB_PAGE);
+        }
+
+        for (i = count; i--;) {
+            z = (zhead_t *)(page + i * blocksize);
+            z->magic = 0xdead;
+            z->tag = TAG_FREE;
+            *(zhead_t **)(z + 1) = s->free;
+            s->free = z;
+        }
+
+        s->total += count;
+        z_slabpages++;
+    }
+
+    z = s->free;
+    s->free = *(zhead_t **)(z + 1);
+    s->count++;
+
+    z->magic = Z_MAGIC_SLAB;
+    return z;
+}
+
+static void Z_SlabFree(zhead_t *z)
+{
+    zslab_t *s = &z_slabs[SLAB_CLASS(z->size - sizeof(*z))];
+
+    z->magic = 0xdead;
+    z->tag = TAG_FREE;
+    *(zhead_t **)(z + 1) = s->free;
+    s->free = z;
+    s->count--;
+}
+
+/*
+========================
+Z_ArenaAlloc
+
+Bumps block from current arena chunk. Big blocks get a chunk of their own so
+that freeing them gives the memory back.
+========================
+*/
+static zhead_t *Z_ArenaAlloc(zarena_t *arena, size_t size)
+{
+    size_t need = Q_ALIGN(size, Z_ARENA_ALIGN);
+    zchunk_t *c = NULL;
+    zhead_t *z;
+
+    if (!LIST_EMPTY(&arena->chunks)) {
+        c = LIST_FIRST(zchunk_t, &arena->chunks, entry);
+        if (c->size - c->used < need) {
+            c = NULL;
+        }
+    }
+
+    if (!c) {
+        bool single = need > Z_ARENA_CHUNK / 4;
+        size_t chunksize = single ? need : Z_ARENA_CHUNK;
+
+        c = malloc(Z_CHUNK_HEAD + chunksize);
+        if (!c) {
+            Com_Error(ERR_FATAL, "%s: couldn't allocate %zu bytes", __func__, Z_CHUNK_HEAD + chunksize);
+        }
+        c->size = chunksize;
+        c->used = 0;
+        c->count = 0;
+
+        if (single) {
+            List_Append(&arena->chunks, &c->entry);
+        } else {
+            List_Insert(&arena->chunks, &c->entry);
+        }
+
+        arena->numchunks++;
+        arena->bytes += Z_CHUNK_HEAD + chunksize;
+    }
+
+    z = (zhead_t *)(Z_CHUNK_DATA(c) + c->used);
+    z->magic = Z_MAGIC_ARENA;
+    z->chunk = c;
+
+    c->used += need;
+    c->count++;
+
+    return z;
+}
+
+static void Z_ArenaFree(zhead_t *z)
+{
+    zarena_t *arena = &z_arenas[z->tag];
+    zchunk_t *c = z->chunk;
+    size_t size = Q_ALIGN(z->size, Z_ARENA_ALIGN);
+
+    z->magic = 0xdead;
+    z->tag = TAG_FREE;
+
+    // give back space of the most recent block
+    if ((byte *)z + size == Z_CHUNK_DATA(c) + c->used) {
+        c->used -= size;
+    }
+
+    if (--c->count) {
+        return;
+    }
+
+    // keep current chunk for reuse
+    if (c == LIST_FIRST(zchunk_t, &arena->chunks, entry) && c->size == Z_ARENA_CHUNK) {
+        c->used = 0;
+        return;
+    }
+
+    List_Remove(&c->entry);
+    arena->numchunks--;
+    arena->bytes -= Z_CHUNK_HEAD + c->size;
+    free(c);
+}
+
+static void Z_ArenaClear(zarena_t *arena)
+{
+    zchunk_t *c, *n;
+
+    LIST_FOR_EACH_SAFE(zchunk_t, c, n, &arena->chunks, entry) {
+        free(c);
+    }
+
+    List_Init(&arena->chunks);
+    arena->numchunks = 0;
+    arena->bytes = 0;
+}
+
+/*
+==============================================================================
+
+SAMPLED ALLOCATION PROFILER
+
+When z_profile_rate is non-zero, one allocation is sampled about every that
+many bytes. Sampled blocks are flagged in the header and their backtraces are
+aggregated per call site and tag, so that live memory can be attributed
+without the cost of tracing every allocation.
+
+==============================================================================
+*/
+
+#define Z_PROFILE_DEPTH     16
+#define Z_PROFILE_HASH      1024
+
+typedef struct zsite_s {
+    struct zsite_s  *next;
+    uint32_t        hash;
+    memtag_t        tag;
+    size_t          live_count, live_bytes;     // sampled
+    size_t          total_count, total_bytes;
+    size_t          live_est, total_est;        // estimated
+    void            *pc[Z_PROFILE_DEPTH];
+} zsite_t;
+
+typedef struct zsample_s {
+    struct zsample_s    *next;
+    const zhead_t       *z;
+    zsite_t             *site;
+    size_t              size;
+    size_t              weight;
+} zsample_t;
+
+static zsite_t      *z_sites[Z_PROFILE_HASH];
+static size_t       z_numsites;
+static zsample_t    *z_samples[Z_PROFILE_HASH];
+static size_t       z_numsamples;
+static int64_t      z_sampleleft;   // bytes until next sample
+static int          z_samplerate;   // rate samples were taken at
+
+#define SAMPLE_HASH(z) \
+    ((uint32_t)((uintptr_t)(z) >> 4) * 0x9e3779b1 >> 22)
+
+static uint32_t Z_HashSite(void **pc, memtag_t tag)
+{
+    const byte *p = (const byte *)pc;
+    uint32_t hash = 2166136261u ^ tag;
+    size_t i;
+
+    for (i = 0; i < sizeof(pc[0]) * Z_PROFILE_DEPTH; i++) {
+        hash = (hash ^ p[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+static void Z_Sample(zhead_t *z, int rate)
+{
+    void *pc[Z_PROFILE_DEPTH] = { NULL };
+    size_t size = z->size - sizeof(*z);
+    zsample_t *sample;
+    zsite_t *site;
+    uint32_t hash;
+
+    Sys_BackTrace(pc, Z_PROFILE_DEPTH, 2);
+
+    hash = Z_HashSite(pc, z->tag);
+    for (site = z_sites[hash & (Z_PROFILE_HASH - 1)]; site; site = site->next) {
+        if (site->hash == hash && site->tag == z->tag && !memcmp(site->pc, pc, sizeof(pc))) {
+            break;
+        }
+    }
+
+    // profiler bookkeeping bypasses zone, so it doesn't sample itself
+    if (!site) {
+        site = calloc(1, sizeof(*site));
+        if (!site) {
+            return;
+        }
+        site->hash = hash;
+        site->tag = z->tag;
+        memcpy(site->pc, pc, sizeof(pc));
+        site->next = z_sites[hash & (Z_PROFILE_HASH - 1)];
+        z_sites[hash & (Z_PROFILE_HASH - 1)] = site;
+        z_numsites++;
+    }
+
+    sample = malloc(sizeof(*sample));
+    if (!sample) {
+        return;
+    }
+    sample->z = z;
+    sample->site = site;
+    sample->size = size;
+    sample->weight = max(size, (size_t)rate);
+    sample->next = z_samples[SAMPLE_HASH(z)];
+    z_samples[SAMPLE_HASH(z)] = sample;
+    z_numsamples++;
+
+    site->live_count++;
+    site->live_bytes += size;
+    site->live_est += sample->weight;
+    site->total_count++;
+    site->total_bytes += size;
+    site->total_est += sample->weight;
+
+    z->magic |= Z_SAMPLED;
+}
+
+static void Z_Unsample(zhead_t *z)
+{
+    zsample_t *sample, **next_p;
+
+    z->magic &= ~Z_SAMPLED;
+
+    next_p = &z_samples[SAMPLE_HASH(z)];
+    for (sample = *next_p; sample; sample = sample->next) {
+        if (sample->z == z) {
+            sample->site->live_count--;
+            sample->site->live_bytes -= sample->size;
+            sample->site->live_est -= sample->weight;
+            *next_p = sample->next;
+            free(sample);
+            z_numsamples--;
+            return;
+        }
+        next_p = &sample->next;
+    }
+}
+
+// drops samples of arena blocks released wholesale by Z_FreeTags
+static void Z_UnsampleTag(memtag_t tag)
+{
+    zsample_t *sample, **next_p;
+    int i;
+
+    for (i = 0; i < Z_PROFILE_HASH && z_numsamples; i++) {
+        next_p = &z_samples[i];
+        while ((sample = *next_p)) {
+            if (sample->site->tag == tag) {
+                sample->site->live_count--;
+                sample->site->live_bytes -= sample->size;
+                sample->site->live_est -= sample->weight;
+                *next_p = sample->next;
+                free(sample);
+                z_numsamples--;
+            } else {
+                next_p = &sample->next;
+            }
+        }
+    }
+}
+
+static inline void Z_ProfileAlloc(zhead_t *z)
+{
+    int rate;
+
+    if (!z_profile_rate || (rate = z_profile_rate->integer) <= 0) {
+        return;
+    }
+
+    z_sampleleft -= z->size - sizeof(*z);
+    if (z_sampleleft > 0) {
+        return;
+    }
+
+    // randomize interval to avoid syncing with allocation patterns
+    z_sampleleft = rate / 2 + Q_rand_uniform(rate);
+    z_samplerate = rate;
+    Z_Sample(z, rate);
+}
+
+static inline void Z_ProfileFree(zhead_t *z)
+{
+    if (z->magic & Z_SAMPLED) {
+        Z_Unsample(z);
+    }
+}
+
 /*
 ========================
 Z_Free
@@ -135,11 +549,26 @@ void Z_Free(void *ptr)
 
     Z_CountFree(z);
 
-    if (z->tag != TAG_STATIC) {
+    if (z->tag == TAG_STATIC) {
+        return;
+    }
+
+    Z_ProfileFree(z);
+
+    switch (z->magic) {
+    case Z_MAGIC_ARENA:
+        Z_ArenaFree(z);
+        break;
+    case Z_MAGIC_SLAB:
+        List_Remove(&z->entry);
+        Z_SlabFree(z);
+        break;
+    default:
         List_Remove(&z->entry);
         z->magic = 0xdead;
         z->tag = TAG_FREE;
         free(z);
+        break;
     }
 }
 
@@ -190,7 +619,28 @@ void *Z_Realloc(void *ptr, size_t size)
 
     Q_assert(z->tag != TAG_STATIC);
 
+    if (Z_KIND(z) != Z_MAGIC) {
+        void *copy;
+
+        // resize in place if still within the same size class
+        if (Z_KIND(z) == Z_MAGIC_SLAB && size - sizeof(*z) <= Z_SLAB_MAX &&
+            SLAB_CLASS(size - sizeof(*z)) == SLAB_CLASS(z->size - sizeof(*z))) {
+            Z_CountFree(z);
+            Z_ProfileFree(z);
+            z->size = size;
+            Z_CountAlloc(z);
+            Z_ProfileAlloc(z);
+            return z + 1;
+        }
+
+        copy = Z_TagMalloc(size - sizeof(*z), z->tag);
+        memcpy(copy, z + 1, min(size, z->size) - sizeof(*z));
+        Z_Free(z + 1);
+        return copy;
+    }
+
     Z_CountFree(z);
+    Z_ProfileFree(z);
 
     z = realloc(z, size);
     if (!z) {
@@ -205,6 +655,8 @@ void *Z_Realloc(void *ptr, size_t size)
     List_Relink(&z->entry);
 
     Z_CountAlloc(z);
+    Z_ProfileAlloc(z);
+    z_allocs++;
 
     return z + 1;
 }
@@ -243,6 +695,39 @@ void Z_Stats_f(void)
     Com_Printf("--------- ------ -------\n"
                "%9zu %6zu total\n",
                bytes, count);
+
+    Com_Printf("scratch peak %d bytes, %zu last frame\n",
+               atomic_load(&z_framepeak), z_framelast);
+
+    if (z_slabpages) {
+        size_t used = 0, total = 0;
+
+        for (i = 0; i < q_countof(z_slabs); i++) {
+            used += z_slabs[i].count;
+            total += z_slabs[i].total;
+        }
+        Com_Printf("%9zu %6zu slab pages (%zu of %zu blocks used)\n",
+                   z_slabpages * Z_SLAB_PAGE, z_slabpages, used, total);
+    }
+
+    for (i = 0; i < TAG_MAX; i++) {
+        if (z_arenas[i].numchunks) {
+            Com_Printf("%9zu %6zu %s arena chunks\n",
+                       z_arenas[i].bytes, z_arenas[i].numchunks, z_tagnames[i]);
+        }
+    }
+}
+
+/*
+========================
+Z_AllocCount
+
+Returns total number of heap allocations made so far, for profiling.
+========================
+*/
+uint64_t Z_AllocCount(void)
+{
+    return z_allocs;
 }
 
 /*
@@ -254,6 +739,14 @@ void Z_FreeTags(memtag_t tag)
 {
     zhead_t *z, *n;
 
+    if (TAG_ARENA(tag)) {
+        Z_UnsampleTag(tag);
+        Z_ArenaClear(&z_arenas[tag]);
+        z_stats[tag].count = 0;
+        z_stats[tag].bytes = 0;
+        return;
+    }
+
     LIST_FOR_EACH_SAFE(zhead_t, z, n, &z_chain, entry) {
         Z_Validate(z);
         if (z->tag == tag) {
@@ -278,29 +771,42 @@ static void *Z_TagMallocInternal(size_t size, memtag_t tag, bool init)
     Q_assert(size <= INT_MAX);
     Q_assert(tag > TAG_FREE && tag <= UINT16_MAX);
 
-    size += sizeof(*z);
-    z = init ? calloc(1, size) : malloc(size);
-    if (!z) {
-        Com_Error(ERR_FATAL, "%s: couldn't allocate %zu bytes", __func__, size);
+    if (TAG_ARENA(tag)) {
+        z = Z_ArenaAlloc(&z_arenas[tag], size + sizeof(*z));
+        if (init) {
+            memset(z + 1, 0, size);
+        }
+    } else if (size <= Z_SLAB_MAX) {
+        z = Z_SlabAlloc(size);
+        if (init) {
+            memset(z + 1, 0, size);
+        }
+        List_Insert(&z_chain, &z->entry);
+    } else {
+        z = init ? calloc(1, size + sizeof(*z)) : malloc(size + sizeof(*z));
+        if (!z) {
+            Com_Error(ERR_FATAL, "%s: couldn't allocate %zu bytes", __func__, size + sizeof(*z));
+        }
+        z->magic = Z_MAGIC;
+        List_Insert(&z_chain, &z->entry);
     }
-    z->magic = Z_MAGIC;
+
     z->tag = tag;
-    z->size = size;
+    z->size = size + sizeof(*z);
 #if USE_MEMORY_TRACES
-    if (!init)
-        memset(z->trace, 0, sizeof(z->trace));
+    memset(z->trace, 0, sizeof(z->trace));
     Sys_BackTrace(z->trace, q_countof(z->trace), 3);
 #endif
 
-    List_Insert(&z_chain, &z->entry);
-
 #if USE_TESTS
     if (!init && z_perturb && z_perturb->integer) {
-        memset(z + 1, z_perturb->integer, size - sizeof(*z));
+        memset(z + 1, z_perturb->integer, size);
     }
 #endif
 
     Z_CountAlloc(z);
+    Z_ProfileAlloc(z);
+    z_allocs++;
 
     return z + 1;
 }
@@ -332,7 +838,13 @@ Z_Init
 */
 void Z_Init(void)
 {
+    int i;
+
     List_Init(&z_chain);
+
+    for (i = 0; i < TAG_MAX; i++) {
+        List_Init(&z_arenas[i].chunks);
+    }
 }
 
 /*
@@ -379,3 +891,353 @@ char *Z_CvarCopyString(const char *in)
     Z_CountAlloc(&z->z);
     return (char *)z->data;
 }
+
+/*
+==============================================================================
+
+PER-FRAME SCRATCH MEMORY
+
+Each thread gets a fixed size bump buffer for transient data that doesn't
+outlive the function that allocates it. Allocations are released in LIFO
+order by rewinding to a mark. Main thread buffer is also reset at the start
+of every frame, which recovers marks skipped by ERR_DROP. Worker threads
+rewind to zero before every job they pick up and free their buffer on exit.
+
+==============================================================================
+*/
+
+size_t Z_FrameMark(void)
+{
+    return z_frame.used;
+}
+
+void *Z_FrameAlloc(size_t size)
+{
+    zframe_t *f = &z_frame;
+    void *ptr;
+
+    if (!f->base) {
+        f->base = malloc(Z_FRAME_SIZE);
+        if (!f->base) {
+            Com_Error(ERR_FATAL, "%s: couldn't allocate %d bytes", __func__, Z_FRAME_SIZE);
+        }
+    }
+
+    size = Q_ALIGN(size, Z_FRAME_ALIGN);
+    if (size > Z_FRAME_SIZE - f->used) {
+        Com_Error(ERR_FATAL, "%s: overflow allocating %zu bytes (%zu in use)",
+                  __func__, size, f->used);
+    }
+
+    ptr = f->base + f->used;
+    f->used += size;
+
+    if (f->used > f->peak) {
+        f->peak = f->used;
+        // racy, but only used for statistics
+        if ((int)f->peak > atomic_load(&z_framepeak)) {
+            atomic_store(&z_framepeak, (int)f->peak);
+        }
+    }
+
+    return ptr;
+}
+
+void Z_FrameRelease(size_t mark)
+{
+    Q_assert(mark <= z_frame.used);
+    z_frame.used = mark;
+}
+
+// called by main thread at frame boundary
+void Z_FrameReset(void)
+{
+    z_framelast = z_frame.peak;
+    z_frame.peak = 0;
+    z_frame.used = 0;
+}
+
+// called by threads before they exit
+void Z_FrameShutdown(void)
+{
+    free(z_frame.base);
+    memset(&z_frame, 0, sizeof(z_frame));
+}
+
+/*
+==============================================================================
+
+PROFILER COMMANDS
+
+==============================================================================
+*/
+
+#define FOR_EACH_SITE(site, i) \
+    for (i = 0; i < Z_PROFILE_HASH; i++) \
+        for (site = z_sites[i]; site; site = site->next)
+
+static const char *Z_TagName(memtag_t tag)
+{
+    static char buffer[16];
+
+    if (tag < TAG_MAX) {
+        return z_tagnames[tag];
+    }
+
+    Q_snprintf(buffer, sizeof(buffer), "game%d", tag - TAG_MAX);
+    return buffer;
+}
+
+// returns index of first frame past the zone allocator and its wrappers.
+// static helpers may not resolve, so skip up to the last named Z_ frame.
+static int Z_SiteStart(const zsite_t *site)
+{
+    char buffer[MAX_QPATH];
+    int i, start = 0;
+
+    for (i = 0; i < 8 && i < Z_PROFILE_DEPTH - 1 && site->pc[i + 1]; i++) {
+        Sys_AddressName(site->pc[i], buffer, sizeof(buffer));
+        if (!strncmp(buffer, "Z_", 2)) {
+            start = i + 1;
+        }
+    }
+
+    return start;
+}
+
+static int sitecmp(const void *p1, const void *p2)
+{
+    const zsite_t *s1 = *(const zsite_t **)p1;
+    const zsite_t *s2 = *(const zsite_t **)p2;
+
+    if (s1->live_est != s2->live_est) {
+        return s1->live_est < s2->live_est ? 1 : -1;
+    }
+    if (s1->total_est != s2->total_est) {
+        return s1->total_est < s2->total_est ? 1 : -1;
+    }
+    return 0;
+}
+
+static void Z_ProfileTop(int count)
+{
+    char name[MAX_QPATH * 3], buffer[MAX_QPATH];
+    zsite_t *site, **sites;
+    size_t len;
+    int i, j, n, start;
+
+    if (!z_numsites) {
+        Com_Printf("No allocations sampled.\n");
+        return;
+    }
+
+    sites = malloc(sizeof(sites[0]) * z_numsites);
+    if (!sites) {
+        return;
+    }
+
+    n = 0;
+    FOR_EACH_SITE(site, i) {
+        sites[n++] = site;
+    }
+
+    qsort(sites, n, sizeof(sites[0]), sitecmp);
+
+    Com_Printf("live bytes samples total bytes tag      site\n"
+               "---------- ------- ----------- -------- ----\n");
+
+    for (i = 0; i < min(count, n); i++) {
+        site = sites[i];
+
+        // show up to 3 innermost frames
+        len = 0;
+        name[0] = 0;
+        start = Z_SiteStart(site);
+        for (j = start; j < min(start + 3, Z_PROFILE_DEPTH) && site->pc[j] && len < sizeof(name); j++) {
+            Sys_AddressName(site->pc[j], buffer, sizeof(buffer));
+            len += Q_snprintf(name + len, sizeof(name) - len, "%s%s", len ? " < " : "", buffer);
+        }
+
+        Com_Printf("%10zu %7zu %11zu %-8s %s\n", site->live_est, site->live_count,
+                   site->total_est, Z_TagName(site->tag), name);
+    }
+
+    free(sites);
+}
+
+// engine tags, plus this many distinct game tags
+#define Z_PROFILE_GAME_TAGS 64
+
+static void Z_ProfileTags(void)
+{
+    struct {
+        memtag_t    tag;
+        size_t      live, total;
+    } tags[TAG_MAX + Z_PROFILE_GAME_TAGS];
+    zsite_t *site;
+    int i, j, numtags = 0, skipped = 0;
+
+    FOR_EACH_SITE(site, i) {
+        for (j = 0; j < numtags; j++) {
+            if (tags[j].tag == site->tag) {
+                break;
+            }
+        }
+        if (j == numtags) {
+            if (numtags == q_countof(tags)) {
+                skipped++;
+                continue;
+            }
+            tags[j].tag = site->tag;
+            tags[j].live = tags[j].total = 0;
+            numtags++;
+        }
+        tags[j].live += site->live_est;
+        tags[j].total += site->total_est;
+    }
+
+    Com_Printf("live bytes total bytes tag\n"
+               "---------- ----------- --------\n");
+
+    for (i = 0; i < numtags; i++) {
+        Com_Printf("%10zu %11zu %s\n", tags[i].live, tags[i].total, Z_TagName(tags[i].tag));
+    }
+
+    if (skipped) {
+        Com_Printf("%d sites not shown, too many distinct tags\n", skipped);
+    }
+}
+
+// writes legacy text heap profile understood by pprof
+static void Z_ProfileDump(qhandle_t f)
+{
+    size_t live_count = 0, live_bytes = 0, total_count = 0, total_bytes = 0;
+    zsite_t *site;
+    int i, j;
+
+    FOR_EACH_SITE(site, i) {
+        live_count += site->live_count;
+        live_bytes += site->live_bytes;
+        total_count += site->total_count;
+        total_bytes += site->total_bytes;
+    }
+
+    FS_FPrintf(f, "heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%d\n",
+               live_count, live_bytes, total_count, total_bytes, z_samplerate);
+
+    FOR_EACH_SITE(site, i) {
+        FS_FPrintf(f, "%zu: %zu [%zu: %zu] @", site->live_count, site->live_bytes,
+                   site->total_count, site->total_bytes);
+        for (j = 0; j < Z_PROFILE_DEPTH && site->pc[j]; j++) {
+            FS_FPrintf(f, " %#"PRIxPTR, (uintptr_t)site->pc[j]);
+        }
+        FS_FPrintf(f, "\n");
+    }
+
+#ifdef __linux__
+    // lets pprof map addresses back to binaries
+    FILE *fp = fopen("/proc/self/maps", "r");
+    if (fp) {
+        char buffer[4096];
+        size_t len;
+
+        FS_FPrintf(f, "\nMAPPED_LIBRARIES:\n");
+        while ((len = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+            FS_Write(buffer, len, f);
+        }
+        fclose(fp);
+    }
+#endif
+}
+
+// writes live bytes in folded stack format, tag name is the root frame
+static void Z_ProfileFolded(qhandle_t f)
+{
+    char buffer[MAX_QPATH], *p;
+    zsite_t *site;
+    int i, j, start;
+
+    FOR_EACH_SITE(site, i) {
+        if (!site->live_est) {
+            continue;
+        }
+
+        FS_FPrintf(f, "%s", Z_TagName(site->tag));
+
+        start = Z_SiteStart(site);
+        for (j = Z_PROFILE_DEPTH - 1; j >= start; j--) {
+            if (!site->pc[j]) {
+                continue;
+            }
+            Sys_AddressName(site->pc[j], buffer, sizeof(buffer));
+            if ((p = strchr(buffer, '+')) && p > buffer) {
+                *p = 0;
+            }
+            FS_FPrintf(f, ";%s", buffer);
+        }
+
+        FS_FPrintf(f, " %zu\n", site->live_est);
+    }
+}
+
+static void Z_ProfileReset(void)
+{
+    zsample_t *sample, *next_sample;
+    zsite_t *site, *next_site;
+    int i;
+
+    for (i = 0; i < Z_PROFILE_HASH; i++) {
+        for (sample = z_samples[i]; sample; sample = next_sample) {
+            next_sample = sample->next;
+            free(sample);
+        }
+        for (site = z_sites[i]; site; site = next_site) {
+            next_site = site->next;
+            free(site);
+        }
+        z_samples[i] = NULL;
+        z_sites[i] = NULL;
+    }
+
+    // blocks may still be flagged, Z_Unsample ignores them
+    z_numsamples = 0;
+    z_numsites = 0;
+}
+
+void Z_Profile_f(void)
+{
+    char path[MAX_OSPATH];
+    char *cmd = Cmd_Argv(1);
+    qhandle_t f;
+
+    if (!strcmp(cmd, "top")) {
+        Z_ProfileTop(Cmd_Argc() > 2 ? Q_atoi(Cmd_Argv(2)) : 20);
+    } else if (!strcmp(cmd, "tags")) {
+        Z_ProfileTags();
+    } else if (!strcmp(cmd, "reset")) {
+        Z_ProfileReset();
+    } else if ((!strcmp(cmd, "dump") || !strcmp(cmd, "folded")) && Cmd_Argc() > 2) {
+        bool folded = !strcmp(cmd, "folded");
+
+        f = FS_EasyOpenFile(path, sizeof(path), FS_MODE_WRITE | FS_FLAG_TEXT,
+                            "profiles/", Cmd_Argv(2), folded ? ".folded" : ".heap");
+        if (!f) {
+            return;
+        }
+
+        if (folded) {
+            Z_ProfileFolded(f);
+        } else {
+            Z_ProfileDump(f);
+        }
+
+        if (FS_CloseFile(f))
+            Com_EPrintf("Error writing %s\n", path);
+        else
+            Com_Printf("Wrote %s.\n", path);
+    } else {
+        Com_Printf("Usage: %s <top [count]|tags|dump <name>|folded <name>|reset>\n", Cmd_Argv(0));
+        Com_Printf("%zu live samples at %zu sites, z_profile_rate is %d.\n",
+                   z_numsamples, z_numsites, z_profile_rate ? z_profile_rate->integer : 0);
+    }
+}
@@ -362,6 +362,9 @@ void T_Damage(edict_t *targ, edict_t *inflictor, edict_t *attacker, const vec3_t
     if (!targ->takedamage)
         return;
 
+    // pain and die functions may start moving or thinking
+    G_WakeEntity(targ);
+
     // easy mode takes half damage
     if (skill->value == 0 && deathmatch->value == 0 && targ->client) {
         damage *= 0.5f;
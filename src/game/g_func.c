@@ -85,7 +85,7 @@ void Move_Final(edict_t *ent)
     VectorScale(ent->moveinfo.dir, ent->moveinfo.remaining_distance / FRAMETIME, ent->velocity);
 
     ent->think = Move_Done;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void Move_Begin(edict_t *ent)
@@ -99,7 +99,7 @@ void Move_Begin(edict_t *ent)
     VectorScale(ent->moveinfo.dir, ent->moveinfo.speed, ent->velocity);
     frames = floorf((ent->moveinfo.remaining_distance / ent->moveinfo.speed) / FRAMETIME);
     ent->moveinfo.remaining_distance -= frames * ent->moveinfo.speed * FRAMETIME;
-    ent->nextthink = level.framenum + frames;
+    G_SetNextThink(ent, level.framenum + frames);
     ent->think = Move_Final;
 }
 
@@ -116,14 +116,14 @@ static void Move_Calc(edict_t *ent, const vec3_t dest, void (*func)(edict_t *))
         if (level.current_entity == ((ent->flags & FL_TEAMSLAVE) ? ent->teammaster : ent)) {
             Move_Begin(ent);
         } else {
-            ent->nextthink = level.framenum + 1;
+            G_SetNextThink(ent, level.framenum + 1);
             ent->think = Move_Begin;
         }
     } else {
         // accelerative
         ent->moveinfo.current_speed = 0;
         ent->think = Think_AccelMove;
-        ent->nextthink = level.framenum + 1;
+        G_SetNextThink(ent, level.framenum + 1);
     }
 }
 
@@ -154,7 +154,7 @@ void AngleMove_Final(edict_t *ent)
     VectorScale(move, 1.0f / FRAMETIME, ent->avelocity);
 
     ent->think = AngleMove_Done;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void AngleMove_Begin(edict_t *ent)
@@ -187,7 +187,7 @@ void AngleMove_Begin(edict_t *ent)
     VectorScale(destdelta, 1.0f / traveltime, ent->avelocity);
 
     // set nextthink to trigger a think when dest is reached
-    ent->nextthink = level.framenum + frames;
+    G_SetNextThink(ent, level.framenum + frames);
     ent->think = AngleMove_Final;
 }
 
@@ -198,7 +198,7 @@ static void AngleMove_Calc(edict_t *ent, void (*func)(edict_t *))
     if (level.current_entity == ((ent->flags & FL_TEAMSLAVE) ? ent->teammaster : ent)) {
         AngleMove_Begin(ent);
     } else {
-        ent->nextthink = level.framenum + 1;
+        G_SetNextThink(ent, level.framenum + 1);
         ent->think = AngleMove_Begin;
     }
 }
@@ -321,7 +321,7 @@ void Think_AccelMove(edict_t *ent)
     }
 
     VectorScale(ent->moveinfo.dir, ent->moveinfo.current_speed * 10, ent->velocity);
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     ent->think = Think_AccelMove;
 }
 
@@ -337,7 +337,7 @@ void plat_hit_top(edict_t *ent)
     ent->moveinfo.state = STATE_TOP;
 
     ent->think = plat_go_down;
-    ent->nextthink = level.framenum + 3 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 3 * BASE_FRAMERATE);
 }
 
 void plat_hit_bottom(edict_t *ent)
@@ -410,7 +410,7 @@ void Touch_Plat_Center(edict_t *ent, edict_t *other, cplane_t *plane, csurface_t
     if (ent->moveinfo.state == STATE_BOTTOM)
         plat_go_up(ent);
     else if (ent->moveinfo.state == STATE_TOP)
-        ent->nextthink = level.framenum + 1 * BASE_FRAMERATE;   // the player is still on the plat, so delay going down
+        G_SetNextThink(ent, level.framenum + 1 * BASE_FRAMERATE);   // the player is still on the plat, so delay going down
 }
 
 static void plat_spawn_inside_trigger(edict_t *ent)
@@ -673,7 +673,7 @@ void button_wait(edict_t *self)
     G_UseTargets(self, self->activator);
     self->s.frame = 1;
     if (self->moveinfo.wait >= 0) {
-        self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
         self->think = button_return;
     }
 }
@@ -830,7 +830,7 @@ void door_hit_top(edict_t *self)
         return;
     if (self->moveinfo.wait >= 0) {
         self->think = door_go_down;
-        self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
     }
 }
 
@@ -872,7 +872,7 @@ static void door_go_up(edict_t *self, edict_t *activator)
     if (self->moveinfo.state == STATE_TOP) {
         // reset top wait time
         if (self->moveinfo.wait >= 0)
-            self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+            G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
         return;
     }
 
@@ -1147,7 +1147,7 @@ void SP_func_door(edict_t *ent)
 
     gi.linkentity(ent);
 
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     if (ent->health || ent->targetname)
         ent->think = Think_CalcMoveSpeed;
     else
@@ -1272,7 +1272,7 @@ void SP_func_door_rotating(edict_t *ent)
 
     gi.linkentity(ent);
 
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     if (ent->health || ent->targetname)
         ent->think = Think_CalcMoveSpeed;
     else
@@ -1353,7 +1353,7 @@ void SP_func_water(edict_t *self)
     if (self->wait == -1)
         self->spawnflags |= DOOR_TOGGLE;
 
-    self->classname = "func_door";
+    G_SetClassname(self, "func_door");
 
     gi.linkentity(self);
 }
@@ -1413,13 +1413,13 @@ void train_wait(edict_t *self)
 
     if (self->moveinfo.wait) {
         if (self->moveinfo.wait > 0) {
-            self->nextthink = level.framenum + self->moveinfo.wait * BASE_FRAMERATE;
+            G_SetNextThink(self, level.framenum + self->moveinfo.wait * BASE_FRAMERATE);
             self->think = train_next;
         } else if (self->spawnflags & TRAIN_TOGGLE) { // && wait < 0
             train_next(self);
             self->spawnflags &= ~TRAIN_START_ON;
             VectorClear(self->velocity);
-            self->nextthink = 0;
+            G_SetNextThink(self, 0);
         }
 
         if (!(self->flags & FL_TEAMSLAVE)) {
@@ -1523,7 +1523,7 @@ void func_train_find(edict_t *self)
         self->spawnflags |= TRAIN_START_ON;
 
     if (self->spawnflags & TRAIN_START_ON) {
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
         self->think = train_next;
         self->activator = self;
     }
@@ -1538,7 +1538,7 @@ void train_use(edict_t *self, edict_t *other, edict_t *activator)
             return;
         self->spawnflags &= ~TRAIN_START_ON;
         VectorClear(self->velocity);
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
     } else {
         if (self->target_ent)
             train_resume(self);
@@ -1578,7 +1578,7 @@ void SP_func_train(edict_t *self)
     if (self->target) {
         // start trains on the second frame, to make sure their targets have had
         // a chance to spawn
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
         self->think = func_train_find;
     } else {
         gi.dprintf("func_train without a target at %s\n", vtos(self->absmin));
@@ -1636,7 +1636,7 @@ void trigger_elevator_init(edict_t *self)
 void SP_trigger_elevator(edict_t *self)
 {
     self->think = trigger_elevator_init;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 /*QUAKED func_timer (0.3 0.1 0.6) (-8 -8 -8) (8 8 8) START_ON
@@ -1656,7 +1656,7 @@ These can used but not touched.
 void func_timer_think(edict_t *self)
 {
     G_UseTargets(self, self->activator);
-    self->nextthink = level.framenum + (self->wait + crandom() * self->random) * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + (self->wait + crandom() * self->random) * BASE_FRAMERATE);
 }
 
 void func_timer_use(edict_t *self, edict_t *other, edict_t *activator)
@@ -1665,13 +1665,13 @@ void func_timer_use(edict_t *self, edict_t *other, edict_t *activator)
 
     // if on, turn it off
     if (self->nextthink) {
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
         return;
     }
 
     // turn it on
     if (self->delay)
-        self->nextthink = level.framenum + self->delay * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + self->delay * BASE_FRAMERATE);
     else
         func_timer_think(self);
 }
@@ -1690,7 +1690,7 @@ void SP_func_timer(edict_t *self)
     }
 
     if (self->spawnflags & 1) {
-        self->nextthink = level.framenum + (1.0f + st.pausetime + self->delay + self->wait + crandom() * self->random) * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + (1.0f + st.pausetime + self->delay + self->wait + crandom() * self->random) * BASE_FRAMERATE);
         self->activator = self;
     }
 
@@ -1771,7 +1771,7 @@ void door_secret_use(edict_t *self, edict_t *other, edict_t *activator)
 
 void door_secret_move1(edict_t *self)
 {
-    self->nextthink = level.framenum + 1.0f * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1.0f * BASE_FRAMERATE);
     self->think = door_secret_move2;
 }
 
@@ -1784,7 +1784,7 @@ void door_secret_move3(edict_t *self)
 {
     if (self->wait == -1)
         return;
-    self->nextthink = level.framenum + self->wait * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + self->wait * BASE_FRAMERATE);
     self->think = door_secret_move4;
 }
 
@@ -1795,7 +1795,7 @@ void door_secret_move4(edict_t *self)
 
 void door_secret_move5(edict_t *self)
 {
-    self->nextthink = level.framenum + 1.0f * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1.0f * BASE_FRAMERATE);
     self->think = door_secret_move6;
 }
 
@@ -1893,7 +1893,7 @@ void SP_func_door_secret(edict_t *ent)
         ent->touch = door_touch;
     }
 
-    ent->classname = "func_door";
+    G_SetClassname(ent, "func_door");
 
     gi.linkentity(ent);
 }
@@ -141,7 +141,7 @@ void SetRespawn(edict_t *ent, float delay)
     ent->flags |= FL_RESPAWN;
     ent->svflags |= SVF_NOCLIENT;
     ent->solid = SOLID_NOT;
-    ent->nextthink = level.framenum + delay * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + delay * BASE_FRAMERATE);
     ent->think = DoRespawn;
     gi.linkentity(ent);
 }
@@ -513,7 +513,7 @@ static void Drop_Ammo(edict_t *ent, const gitem_t *item)
 void MegaHealth_think(edict_t *self)
 {
     if (self->owner->health > self->owner->max_health) {
-        self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
         self->owner->health -= 1;
         return;
     }
@@ -539,7 +539,7 @@ static bool Pickup_Health(edict_t *ent, edict_t *other)
 
     if (ent->style & HEALTH_TIMED) {
         ent->think = MegaHealth_think;
-        ent->nextthink = level.framenum + 5 * BASE_FRAMERATE;
+        G_SetNextThink(ent, level.framenum + 5 * BASE_FRAMERATE);
         ent->owner = other;
         ent->flags |= FL_RESPAWN;
         ent->svflags |= SVF_NOCLIENT;
@@ -784,7 +784,7 @@ void drop_make_touchable(edict_t *ent)
 {
     ent->touch = Touch_Item;
     if (deathmatch->value) {
-        ent->nextthink = level.framenum + 29 * BASE_FRAMERATE;
+        G_SetNextThink(ent, level.framenum + 29 * BASE_FRAMERATE);
         ent->think = G_FreeEdict;
     }
 }
@@ -797,7 +797,7 @@ edict_t *Drop_Item(edict_t *ent, const gitem_t *item)
 
     dropped = G_Spawn();
 
-    dropped->classname = item->classname;
+    G_SetClassname(dropped, item->classname);
     dropped->item = item;
     dropped->spawnflags = DROPPED_ITEM;
     dropped->s.effects = item->world_model_flags;
@@ -828,7 +828,7 @@ edict_t *Drop_Item(edict_t *ent, const gitem_t *item)
     dropped->velocity[2] = 300;
 
     dropped->think = drop_make_touchable;
-    dropped->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+    G_SetNextThink(dropped, level.framenum + 1 * BASE_FRAMERATE);
 
     gi.linkentity(dropped);
 
@@ -894,7 +894,7 @@ void droptofloor(edict_t *ent)
         ent->svflags |= SVF_NOCLIENT;
         ent->solid = SOLID_NOT;
         if (ent == ent->teammaster) {
-            ent->nextthink = level.framenum + 1;
+            G_SetNextThink(ent, level.framenum + 1);
             ent->think = DoRespawn;
         }
     }
@@ -1027,7 +1027,7 @@ void SpawnItem(edict_t *ent, const gitem_t *item)
     }
 
     ent->item = item;
-    ent->nextthink = level.framenum + 2;    // items start after other solids
+    G_SetNextThink(ent, level.framenum + 2);    // items start after other solids
     ent->think = droptofloor;
     ent->s.effects = item->world_model_flags;
     ent->s.renderfx = RF_GLOW;
@@ -641,6 +641,12 @@ void    G_FreeEdict(edict_t *e);
 
 void    G_TouchTriggers(edict_t *ent);
 
+void    G_SetClassname(edict_t *ent, char *classname);
+void    G_SetTargetname(edict_t *ent, char *targetname);
+void    G_IndexEntity(edict_t *ent);
+void    G_ResetEntityIndex(void);
+void    G_InitEntityIndex(void);
+
 char    *G_CopyString(char *in);
 
 float vectoyaw(vec3_t vec);
@@ -802,6 +808,13 @@ void M_ChangeYaw(edict_t *ent);
 // g_phys.c
 //
 void G_RunEntity(edict_t *ent);
+void G_WakeEntity(edict_t *ent);
+void G_SetNextThink(edict_t *ent, int framenum);
+void G_SleepEntity(edict_t *ent);
+int G_NextActiveEntity(int n);
+void G_WakeThinkers(void);
+void G_ResetEntitySchedule(void);
+void G_InitEntitySchedule(void);
 
 //
 // g_chase.c
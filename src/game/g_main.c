@@ -181,6 +181,8 @@ static void InitGame(void)
     g_edicts = gi.TagMalloc(game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
     globals.edicts = g_edicts;
     globals.max_edicts = game.maxentities;
+    G_InitEntitySchedule();
+    G_InitEntityIndex();
 
     // initialize all clients for this game
     game.maxclients = maxclients->value;
@@ -291,7 +293,7 @@ static edict_t *CreateTargetChangeLevel(char *map)
     edict_t *ent;
 
     ent = G_Spawn();
-    ent->classname = "target_changelevel";
+    G_SetClassname(ent, "target_changelevel");
     if (map != level.nextmap)
         Q_strlcpy(level.nextmap, map, sizeof(level.nextmap));
     ent->map = level.nextmap;
@@ -469,6 +471,10 @@ static void G_RunFrame(void)
     // choose a client for monsters to target this frame
     AI_SetSightClient();
 
+    // wake up entities whose think is due. must be done every frame, even
+    // when exiting, or this slot of the wheel won't be seen for a full lap.
+    G_WakeThinkers();
+
     // exit intermissions
     if (level.exitintermission) {
         ExitLevel();
@@ -476,13 +482,15 @@ static void G_RunFrame(void)
     }
 
     //
-    // treat each object in turn
+    // treat each active object in turn
     // even the world gets a chance to think
     //
-    ent = &g_edicts[0];
-    for (i = 0; i < globals.num_edicts; i++, ent++) {
-        if (!ent->inuse)
+    for (i = G_NextActiveEntity(0); i < globals.num_edicts; i = G_NextActiveEntity(i + 1)) {
+        ent = &g_edicts[i];
+        if (!ent->inuse) {
+            G_SleepEntity(ent);
             continue;
+        }
 
         level.current_entity = ent;
 
@@ -503,6 +511,7 @@ static void G_RunFrame(void)
         }
 
         G_RunEntity(ent);
+        G_SleepEntity(ent);
     }
 
     // exit intermission right now to avoid annoying fov change
@@ -78,11 +78,11 @@ gibs
 void gib_think(edict_t *self)
 {
     self->s.frame++;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 
     if (self->s.frame == 10) {
         self->think = G_FreeEdict;
-        self->nextthink = level.framenum + (8 + random() * 10) * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + (8 + random() * 10) * BASE_FRAMERATE);
     }
 }
 
@@ -105,7 +105,7 @@ void gib_touch(edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf)
         if (self->s.modelindex == sm_meat_index) {
             self->s.frame++;
             self->think = gib_think;
-            self->nextthink = level.framenum + 1;
+            G_SetNextThink(self, level.framenum + 1);
         }
     }
 }
@@ -153,7 +153,7 @@ void ThrowGib(edict_t *self, char *gibname, int damage, int type)
     gib->avelocity[2] = random() * 600;
 
     gib->think = G_FreeEdict;
-    gib->nextthink = level.framenum + (10 + random() * 10) * BASE_FRAMERATE;
+    G_SetNextThink(gib, level.framenum + (10 + random() * 10) * BASE_FRAMERATE);
 
     gi.linkentity(gib);
 }
@@ -195,7 +195,7 @@ void ThrowHead(edict_t *self, char *gibname, int damage, int type)
     self->avelocity[YAW] = crandom() * 600;
 
     self->think = G_FreeEdict;
-    self->nextthink = level.framenum + (10 + random() * 10) * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + (10 + random() * 10) * BASE_FRAMERATE);
 
     gi.linkentity(self);
 }
@@ -234,7 +234,7 @@ void ThrowClientHead(edict_t *self, int damage)
         self->client->anim_end = self->s.frame;
     } else {
         self->think = NULL;
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
     }
 
     gi.linkentity(self);
@@ -268,10 +268,10 @@ void ThrowDebris(edict_t *self, char *modelname, float speed, vec3_t origin)
     chunk->avelocity[1] = random() * 600;
     chunk->avelocity[2] = random() * 600;
     chunk->think = G_FreeEdict;
-    chunk->nextthink = level.framenum + (5 + random() * 5) * BASE_FRAMERATE;
+    G_SetNextThink(chunk, level.framenum + (5 + random() * 5) * BASE_FRAMERATE);
     chunk->s.frame = 0;
     chunk->flags = 0;
-    chunk->classname = "debris";
+    G_SetClassname(chunk, "debris");
     chunk->takedamage = DAMAGE_YES;
     chunk->die = debris_die;
     gi.linkentity(chunk);
@@ -441,7 +441,7 @@ Just for the debugging level.  Don't use
 void TH_viewthing(edict_t *ent)
 {
     ent->s.frame = (ent->s.frame + 1) % 7;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void SP_viewthing(edict_t *ent)
@@ -455,7 +455,7 @@ void SP_viewthing(edict_t *ent)
     VectorSet(ent->maxs, 16, 16, 32);
     ent->s.modelindex = gi.modelindex("models/objects/banner/tris.md2");
     gi.linkentity(ent);
-    ent->nextthink = level.framenum + 0.5f * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 0.5f * BASE_FRAMERATE);
     ent->think = TH_viewthing;
     return;
 }
@@ -635,7 +635,7 @@ void SP_func_object(edict_t *self)
         self->solid = SOLID_BSP;
         self->movetype = MOVETYPE_PUSH;
         self->think = func_object_release;
-        self->nextthink = level.framenum + 2;
+        G_SetNextThink(self, level.framenum + 2);
     } else {
         self->solid = SOLID_NOT;
         self->movetype = MOVETYPE_PUSH;
@@ -847,7 +847,7 @@ void barrel_explode(edict_t *self)
 void barrel_delay(edict_t *self, edict_t *inflictor, edict_t *attacker, int damage, vec3_t point)
 {
     self->takedamage = DAMAGE_NO;
-    self->nextthink = level.framenum + 2;
+    G_SetNextThink(self, level.framenum + 2);
     self->think = barrel_explode;
     self->activator = attacker;
 }
@@ -886,7 +886,7 @@ void SP_misc_explobox(edict_t *self)
     self->touch = barrel_touch;
 
     self->think = M_droptofloor;
-    self->nextthink = level.framenum + 2;
+    G_SetNextThink(self, level.framenum + 2);
 
     gi.linkentity(self);
 }
@@ -912,10 +912,10 @@ void misc_blackhole_use(edict_t *ent, edict_t *other, edict_t *activator)
 void misc_blackhole_think(edict_t *self)
 {
     if (++self->s.frame < 19)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 0;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -929,7 +929,7 @@ void SP_misc_blackhole(edict_t *ent)
     ent->s.renderfx = RF_TRANSLUCENT | RF_NOSHADOW;
     ent->use = misc_blackhole_use;
     ent->think = misc_blackhole_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -939,10 +939,10 @@ void SP_misc_blackhole(edict_t *ent)
 void misc_eastertank_think(edict_t *self)
 {
     if (++self->s.frame < 293)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 254;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -955,7 +955,7 @@ void SP_misc_eastertank(edict_t *ent)
     ent->s.modelindex = gi.modelindex("models/monsters/tank/tris.md2");
     ent->s.frame = 254;
     ent->think = misc_eastertank_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -965,10 +965,10 @@ void SP_misc_eastertank(edict_t *ent)
 void misc_easterchick_think(edict_t *self)
 {
     if (++self->s.frame < 247)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 208;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -981,7 +981,7 @@ void SP_misc_easterchick(edict_t *ent)
     ent->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
     ent->s.frame = 208;
     ent->think = misc_easterchick_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -991,10 +991,10 @@ void SP_misc_easterchick(edict_t *ent)
 void misc_easterchick2_think(edict_t *self)
 {
     if (++self->s.frame < 287)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 248;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -1007,7 +1007,7 @@ void SP_misc_easterchick2(edict_t *ent)
     ent->s.modelindex = gi.modelindex("models/monsters/bitch/tris.md2");
     ent->s.frame = 248;
     ent->think = misc_easterchick2_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     gi.linkentity(ent);
 }
 
@@ -1019,9 +1019,9 @@ There should be a item_commander_head that has this as it's target.
 void commander_body_think(edict_t *self)
 {
     if (++self->s.frame < 24)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else
-        self->nextthink = 0;
+        G_SetNextThink(self, 0);
 
     if (self->s.frame == 22)
         gi.sound(self, CHAN_BODY, gi.soundindex("tank/thud.wav"), 1, ATTN_NORM, 0);
@@ -1030,7 +1030,7 @@ void commander_body_think(edict_t *self)
 void commander_body_use(edict_t *self, edict_t *other, edict_t *activator)
 {
     self->think = commander_body_think;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     gi.sound(self, CHAN_BODY, gi.soundindex("tank/pain.wav"), 1, ATTN_NORM, 0);
 }
 
@@ -1058,7 +1058,7 @@ void SP_monster_commander_body(edict_t *self)
     gi.soundindex("tank/pain.wav");
 
     self->think = commander_body_drop;
-    self->nextthink = level.framenum + 5;
+    G_SetNextThink(self, level.framenum + 5);
 }
 
 /*QUAKED misc_banner (1 .5 0) (-4 -4 -4) (4 4 4)
@@ -1068,7 +1068,7 @@ The banner is 128 tall.
 void misc_banner_think(edict_t *ent)
 {
     ent->s.frame = (ent->s.frame + 1) % 16;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 void SP_misc_banner(edict_t *ent)
@@ -1081,7 +1081,7 @@ void SP_misc_banner(edict_t *ent)
     gi.linkentity(ent);
 
     ent->think = misc_banner_think;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
 }
 
 /*QUAKED misc_deadsoldier (1 .5 0) (-16 -16 0) (16 16 16) ON_BACK ON_STOMACH BACK_DECAP FETAL_POS SIT_DECAP IMPALED
@@ -1173,7 +1173,7 @@ void SP_misc_viper(edict_t *ent)
     VectorSet(ent->maxs, 16, 16, 32);
 
     ent->think = func_train_find;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     ent->use = misc_viper_use;
     ent->svflags |= SVF_NOCLIENT;
     ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed = ent->speed;
@@ -1300,7 +1300,7 @@ void SP_misc_strogg_ship(edict_t *ent)
     VectorSet(ent->maxs, 16, 16, 32);
 
     ent->think = func_train_find;
-    ent->nextthink = level.framenum + 1;
+    G_SetNextThink(ent, level.framenum + 1);
     ent->use = misc_strogg_ship_use;
     ent->svflags |= SVF_NOCLIENT;
     ent->moveinfo.accel = ent->moveinfo.decel = ent->moveinfo.speed = ent->speed;
@@ -1314,14 +1314,14 @@ void misc_satellite_dish_think(edict_t *self)
 {
     self->s.frame++;
     if (self->s.frame < 38)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
 }
 
 void misc_satellite_dish_use(edict_t *self, edict_t *other, edict_t *activator)
 {
     self->s.frame = 0;
     self->think = misc_satellite_dish_think;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 void SP_misc_satellite_dish(edict_t *ent)
@@ -1372,7 +1372,7 @@ void SP_misc_gib_arm(edict_t *ent)
     ent->avelocity[1] = random() * 200;
     ent->avelocity[2] = random() * 200;
     ent->think = G_FreeEdict;
-    ent->nextthink = level.framenum + 30 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 30 * BASE_FRAMERATE);
     gi.linkentity(ent);
 }
 
@@ -1393,7 +1393,7 @@ void SP_misc_gib_leg(edict_t *ent)
     ent->avelocity[1] = random() * 200;
     ent->avelocity[2] = random() * 200;
     ent->think = G_FreeEdict;
-    ent->nextthink = level.framenum + 30 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 30 * BASE_FRAMERATE);
     gi.linkentity(ent);
 }
 
@@ -1414,7 +1414,7 @@ void SP_misc_gib_head(edict_t *ent)
     ent->avelocity[1] = random() * 200;
     ent->avelocity[2] = random() * 200;
     ent->think = G_FreeEdict;
-    ent->nextthink = level.framenum + 30 * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 30 * BASE_FRAMERATE);
     gi.linkentity(ent);
 }
 
@@ -1543,6 +1543,7 @@ void func_clock_think(edict_t *self)
     }
 
     self->enemy->message = self->message;
+    G_WakeEntity(self->enemy);
     self->enemy->use(self->enemy, self, self);
 
     if (((self->spawnflags & 1) && (self->health > self->wait)) ||
@@ -1569,7 +1570,7 @@ void func_clock_think(edict_t *self)
             return;
     }
 
-    self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
 }
 
 void func_clock_use(edict_t *self, edict_t *other, edict_t *activator)
@@ -1608,7 +1609,7 @@ void SP_func_clock(edict_t *self)
     if (self->spawnflags & 4)
         self->use = func_clock_use;
     else
-        self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
 }
 
 //=================================================================================
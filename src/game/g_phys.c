@@ -118,8 +118,10 @@ static void SV_Impact(edict_t *e1, trace_t *trace)
     if (e1->touch && e1->solid != SOLID_NOT)
         e1->touch(e1, e2, &trace->plane, trace->surface);
 
-    if (e2->touch && e2->solid != SOLID_NOT)
+    if (e2->touch && e2->solid != SOLID_NOT) {
+        G_WakeEntity(e2);
         e2->touch(e2, e1, NULL, NULL);
+    }
 }
 
 /*
@@ -541,7 +543,7 @@ static void SV_Physics_Pusher(edict_t *ent)
         // the move failed, bump all nextthink times and back out moves
         for (mv = ent; mv; mv = mv->teamchain) {
             if (mv->nextthink > 0)
-                mv->nextthink++;
+                G_SetNextThink(mv, mv->nextthink + 1);
         }
 
         // if the pusher has a "blocked" function, call it
@@ -890,3 +892,231 @@ void G_RunEntity(edict_t *ent)
         gi.error("SV_Physics: bad movetype %i", ent->movetype);
     }
 }
+
+/*
+==============================================================================
+
+ENTITY SCHEDULING
+
+Non-moving entities (triggers, lights, path corners, etc) make up most of
+the entities on big maps, yet they only need attention when their think
+function is due. Such entities are put to sleep after they have been run,
+and their next think is stored in a timer wheel. Everything that can change
+their state (setting nextthink, linking, use/touch/pain/die callbacks) wakes
+them up again. Running an entity that has nothing to do is harmless, so
+waking entities liberally never changes behaviour.
+
+==============================================================================
+*/
+
+#define THINK_WHEEL_SIZE    256     // must be power of two
+
+static struct {
+    uint32_t    *active;            // bitmap of entities to run
+    int         *next, *prev;       // think wheel links, -1 terminated
+    int         *time;              // scheduled think frame, 0 if none
+    int         wheel[THINK_WHEEL_SIZE];
+} sched;
+
+static void (*real_linkentity)(edict_t *ent);
+
+static void G_UnscheduleThink(int n)
+{
+    int *head;
+
+    if (!sched.time[n])
+        return;
+
+    head = &sched.wheel[sched.time[n] & (THINK_WHEEL_SIZE - 1)];
+    if (sched.prev[n] == -1)
+        *head = sched.next[n];
+    else
+        sched.next[sched.prev[n]] = sched.next[n];
+    if (sched.next[n] != -1)
+        sched.prev[sched.next[n]] = sched.prev[n];
+
+    sched.time[n] = 0;
+}
+
+static void G_ScheduleThink(int n, int framenum)
+{
+    int *head;
+
+    if (sched.time[n] == framenum)
+        return;
+
+    G_UnscheduleThink(n);
+
+    head = &sched.wheel[framenum & (THINK_WHEEL_SIZE - 1)];
+    sched.prev[n] = -1;
+    sched.next[n] = *head;
+    if (*head != -1)
+        sched.prev[*head] = n;
+    *head = n;
+
+    sched.time[n] = framenum;
+}
+
+/*
+================
+G_WakeEntity
+
+Makes sure entity is run on the next pass of G_RunFrame.
+================
+*/
+void G_WakeEntity(edict_t *ent)
+{
+    int n = ent - g_edicts;
+
+    sched.active[n >> 5] |= BIT(n & 31);
+
+    // team slaves think through their captain
+    if (ent->teammaster && ent->teammaster != ent) {
+        n = ent->teammaster - g_edicts;
+        sched.active[n >> 5] |= BIT(n & 31);
+    }
+}
+
+/*
+================
+G_SetNextThink
+================
+*/
+void G_SetNextThink(edict_t *ent, int framenum)
+{
+    ent->nextthink = framenum;
+    G_WakeEntity(ent);
+}
+
+static void G_LinkEntity(edict_t *ent)
+{
+    G_WakeEntity(ent);
+    real_linkentity(ent);
+}
+
+/*
+================
+G_SleepEntity
+
+Called after entity has been run. Removes the entity from the active set if
+running it again would have no effect until its next think.
+================
+*/
+void G_SleepEntity(edict_t *ent)
+{
+    int n = ent - g_edicts;
+
+    // world and clients are always run
+    if (n <= game.maxclients)
+        return;
+
+    if (ent->inuse) {
+        if (ent->movetype != MOVETYPE_NONE)
+            return;
+        if (ent->prethink || ent->groundentity)
+            return;
+        if (!(ent->s.renderfx & RF_BEAM) && !VectorCompare(ent->s.origin, ent->s.old_origin))
+            return;
+
+        if (ent->nextthink > level.framenum)
+            G_ScheduleThink(n, ent->nextthink);
+        else if (ent->nextthink > 0)
+            return;
+        else
+            G_UnscheduleThink(n);
+    } else {
+        G_UnscheduleThink(n);
+    }
+
+    sched.active[n >> 5] &= ~BIT(n & 31);
+}
+
+/*
+================
+G_NextActiveEntity
+
+Returns number of the first active entity starting from n, or
+game.maxentities if there are none.
+================
+*/
+int G_NextActiveEntity(int n)
+{
+    uint32_t w;
+
+    while (n < game.maxentities) {
+        w = sched.active[n >> 5] >> (n & 31);
+        if (!w) {
+            n = (n | 31) + 1;
+            continue;
+        }
+        while (!(w & 1)) {
+            w >>= 1;
+            n++;
+        }
+        break;
+    }
+
+    return min(n, game.maxentities);
+}
+
+/*
+================
+G_WakeThinkers
+
+Wakes up entities whose think is due this frame.
+================
+*/
+void G_WakeThinkers(void)
+{
+    int n, next;
+
+    for (n = sched.wheel[level.framenum & (THINK_WHEEL_SIZE - 1)]; n != -1; n = next) {
+        next = sched.next[n];
+        if (sched.time[n] > level.framenum)
+            continue;   // not this lap of the wheel
+        G_UnscheduleThink(n);
+        G_WakeEntity(&g_edicts[n]);
+    }
+}
+
+/*
+================
+G_ResetEntitySchedule
+
+Forgets all scheduled thinks and marks every entity as active.
+Should be called after g_edicts has been wiped.
+================
+*/
+void G_ResetEntitySchedule(void)
+{
+    int i;
+
+    for (i = 0; i < THINK_WHEEL_SIZE; i++)
+        sched.wheel[i] = -1;
+
+    memset(sched.time, 0, game.maxentities * sizeof(sched.time[0]));
+    memset(sched.active, 0xff, ((game.maxentities + 31) >> 5) * sizeof(sched.active[0]));
+}
+
+/*
+================
+G_InitEntitySchedule
+
+Should be called after g_edicts has been allocated.
+================
+*/
+void G_InitEntitySchedule(void)
+{
+    sched.active = gi.TagMalloc(((game.maxentities + 31) >> 5) * sizeof(sched.active[0]), TAG_GAME);
+    sched.next = gi.TagMalloc(game.maxentities * sizeof(sched.next[0]), TAG_GAME);
+    sched.prev = gi.TagMalloc(game.maxentities * sizeof(sched.prev[0]), TAG_GAME);
+    sched.time = gi.TagMalloc(game.maxentities * sizeof(sched.time[0]), TAG_GAME);
+
+    G_ResetEntitySchedule();
+
+    // linking is the most common way for entities to change each other
+    if (gi.linkentity != G_LinkEntity) {
+        real_linkentity = gi.linkentity;
+        gi.linkentity = G_LinkEntity;
+    }
+}
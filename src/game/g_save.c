@@ -24,7 +24,6 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #else
 #define gzopen(name, mode)          fopen(name, mode)
 #define gzclose(file)               fclose(file)
-#define gzwrite(file, buf, len)     fwrite(buf, 1, len, file)
 #define gzread(file, buf, len)      fread(buf, 1, len, file)
 #define gzbuffer(file, size)        (void)0
 #define gzFile                      FILE *
@@ -449,33 +448,130 @@ static const save_field_t gamefields[] = {
 
 //=========================================================
 
-static void write_data(void *buf, size_t len, gzFile f)
+typedef struct {
+    byte    *data;
+    size_t  maxsize;
+    size_t  cursize;
+    size_t  readcount;
+
+    // level savegames reference function pointers through a table of
+    // save_ptrs indices stored in the file, instead of directly
+    int     *ptrs;      // table index -> save_ptrs index
+    int     numptrs;
+    uint16_t *ptrmap;   // save_ptrs index -> table index + 1, for writing
+} savebuf_t;
+
+// must be a power of two larger than num_save_ptrs
+#define SAVE_PTR_HASH_SIZE  2048
+
+// 1-based indices into save_ptrs, 0 if slot is empty
+static uint16_t save_ptr_hash[SAVE_PTR_HASH_SIZE];
+
+static int hash_pointer(const void *p, ptr_type_t type)
+{
+    uintptr_t v = (uintptr_t)p ^ type;
+
+    v ^= v >> 16;
+    v *= 0x45d9f3b;
+    v ^= v >> 16;
+
+    return v & (SAVE_PTR_HASH_SIZE - 1);
+}
+
+/*
+=============
+init_save_ptrs
+
+Builds pointer lookup table once, so that write_pointer() doesn't need
+to search through all save_ptrs for every function pointer saved.
+=============
+*/
+static void init_save_ptrs(void)
 {
-    if (gzwrite(f, buf, len) != len) {
-        gzclose(f);
-        gi.error("%s: couldn't write %zu bytes", __func__, len);
+    static bool initialized;
+    int i, j;
+
+    if (initialized)
+        return;
+
+    if (num_save_ptrs >= SAVE_PTR_HASH_SIZE)
+        gi.error("%s: too many save pointers", __func__);
+
+    for (i = 0; i < num_save_ptrs; i++) {
+        for (j = hash_pointer(save_ptrs[i].ptr, save_ptrs[i].type); save_ptr_hash[j]; j = (j + 1) & (SAVE_PTR_HASH_SIZE - 1))
+            ;
+        save_ptr_hash[j] = i + 1;
     }
+
+    initialized = true;
+}
+
+static savebuf_t *alloc_buffer(void)
+{
+    savebuf_t *f = gi.TagMalloc(sizeof(*f), TAG_GAME);
+
+    f->maxsize = 0x10000;
+    f->data = gi.TagMalloc(f->maxsize, TAG_GAME);
+
+    return f;
+}
+
+static void free_buffer(savebuf_t *f)
+{
+    if (f->ptrs)
+        gi.TagFree(f->ptrs);
+    if (f->ptrmap)
+        gi.TagFree(f->ptrmap);
+    gi.TagFree(f->data);
+    gi.TagFree(f);
+}
+
+static void grow_buffer(savebuf_t *f, size_t len)
+{
+    byte *data;
+
+    if (len <= f->maxsize - f->cursize)
+        return;
+
+    f->maxsize = max(f->maxsize * 2, f->cursize + len);
+    data = gi.TagMalloc(f->maxsize, TAG_GAME);
+    memcpy(data, f->data, f->cursize);
+    gi.TagFree(f->data);
+    f->data = data;
+}
+
+static void write_data(void *buf, size_t len, savebuf_t *f)
+{
+    grow_buffer(f, len);
+    memcpy(f->data + f->cursize, buf, len);
+    f->cursize += len;
 }
 
-static void write_short(gzFile f, int16_t v)
+static void write_short(savebuf_t *f, int16_t v)
 {
     v = LittleShort(v);
     write_data(&v, sizeof(v), f);
 }
 
-static void write_int(gzFile f, int32_t v)
+static void write_int(savebuf_t *f, int32_t v)
 {
     v = LittleLong(v);
     write_data(&v, sizeof(v), f);
 }
 
-static void write_float(gzFile f, float v)
+static void patch_int(savebuf_t *f, size_t ofs, int32_t v)
+{
+    v = LittleLong(v);
+    memcpy(f->data + ofs, &v, sizeof(v));
+}
+
+static void write_float(savebuf_t *f, float v)
 {
     v = LittleFloat(v);
     write_data(&v, sizeof(v), f);
 }
 
-static void write_string(gzFile f, char *s)
+static void write_string(savebuf_t *f, char *s)
 {
     size_t len;
 
@@ -486,21 +582,21 @@ static void write_string(gzFile f, char *s)
 
     len = strlen(s);
     if (len >= 65536) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: bad length", __func__);
     }
     write_int(f, len);
     write_data(s, len, f);
 }
 
-static void write_vector(gzFile f, vec_t *v)
+static void write_vector(savebuf_t *f, vec_t *v)
 {
     write_float(f, v[0]);
     write_float(f, v[1]);
     write_float(f, v[2]);
 }
 
-static void write_index(gzFile f, void *p, size_t size, const void *start, int max_index)
+static void write_index(savebuf_t *f, void *p, size_t size, const void *start, int max_index)
 {
     uintptr_t diff;
 
@@ -511,38 +607,52 @@ static void write_index(gzFile f, void *p, size_t size, const void *start, int m
 
     diff = (uintptr_t)p - (uintptr_t)start;
     if (diff > max_index * size) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: pointer out of range: %p", __func__, p);
     }
     if (diff % size) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: misaligned pointer: %p", __func__, p);
     }
     write_int(f, (int)(diff / size));
 }
 
-static void write_pointer(gzFile f, void *p, ptr_type_t type)
+static void write_pointer(savebuf_t *f, void *p, ptr_type_t type)
 {
     const save_ptr_t *ptr;
-    int i;
+    int i, index;
 
     if (!p) {
-        write_int(f, -1);
+        if (f->ptrmap)
+            write_short(f, -1);
+        else
+            write_int(f, -1);
         return;
     }
 
-    for (i = 0, ptr = save_ptrs; i < num_save_ptrs; i++, ptr++) {
-        if (ptr->type == type && ptr->ptr == p) {
-            write_int(f, i);
+    init_save_ptrs();
+
+    for (i = hash_pointer(p, type); (index = save_ptr_hash[i]); i = (i + 1) & (SAVE_PTR_HASH_SIZE - 1)) {
+        ptr = &save_ptrs[index - 1];
+        if (ptr->type != type || ptr->ptr != p)
+            continue;
+        if (!f->ptrmap) {
+            write_int(f, index - 1);
             return;
         }
+        if (!f->ptrmap[index - 1]) {
+            f->ptrs[f->numptrs++] = index - 1;
+            f->ptrmap[index - 1] = f->numptrs;
+        }
+        write_short(f, f->ptrmap[index - 1] - 1);
+        return;
     }
 
-    gzclose(f);
+    free_buffer(f);
     gi.error("%s: unknown pointer: %p", __func__, p);
 }
 
-static void write_field(gzFile f, const save_field_t *field, void *base)
+static void write_field(savebuf_t *f, const save_field_t *field, void *base)
 {
     void *p = (byte *)base + field->ofs;
     int i;
@@ -601,7 +711,7 @@ static void write_field(gzFile f, const save_field_t *field, void *base)
     }
 }
 
-static void write_fields(gzFile f, const save_field_t *fields, void *base)
+static void write_fields(savebuf_t *f, const save_field_t *fields, void *base)
 {
     const save_field_t *field;
 
@@ -610,15 +720,18 @@ static void write_fields(gzFile f, const save_field_t *fields, void *base)
     }
 }
 
-static void read_data(void *buf, size_t len, gzFile f)
+static void read_data(void *buf, size_t len, savebuf_t *f)
 {
-    if (gzread(f, buf, len) != len) {
-        gzclose(f);
+    if (len > f->cursize - f->readcount) {
+        free_buffer(f);
         gi.error("%s: couldn't read %zu bytes", __func__, len);
     }
+
+    memcpy(buf, f->data + f->readcount, len);
+    f->readcount += len;
 }
 
-static int read_short(gzFile f)
+static int read_short(savebuf_t *f)
 {
     int16_t v;
 
@@ -628,7 +741,7 @@ static int read_short(gzFile f)
     return v;
 }
 
-static int read_int(gzFile f)
+static int read_int(savebuf_t *f)
 {
     int32_t v;
 
@@ -638,7 +751,7 @@ static int read_int(gzFile f)
     return v;
 }
 
-static float read_float(gzFile f)
+static float read_float(savebuf_t *f)
 {
     float v;
 
@@ -648,7 +761,7 @@ static float read_float(gzFile f)
     return v;
 }
 
-static char *read_string(gzFile f)
+static char *read_string(savebuf_t *f)
 {
     int len;
     char *s;
@@ -659,7 +772,7 @@ static char *read_string(gzFile f)
     }
 
     if (len < 0 || len >= 65536) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: bad length", __func__);
     }
 
@@ -670,13 +783,13 @@ static char *read_string(gzFile f)
     return s;
 }
 
-static void read_zstring(gzFile f, char *s, size_t size)
+static void read_zstring(savebuf_t *f, char *s, size_t size)
 {
     int len;
 
     len = read_int(f);
     if (len < 0 || len >= size) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: bad length", __func__);
     }
 
@@ -684,14 +797,14 @@ static void read_zstring(gzFile f, char *s, size_t size)
     s[len] = 0;
 }
 
-static void read_vector(gzFile f, vec_t *v)
+static void read_vector(savebuf_t *f, vec_t *v)
 {
     v[0] = read_float(f);
     v[1] = read_float(f);
     v[2] = read_float(f);
 }
 
-static void *read_index(gzFile f, size_t size, const void *start, int max_index)
+static void *read_index(savebuf_t *f, size_t size, const void *start, int max_index)
 {
     int index;
     byte *p;
@@ -702,7 +815,7 @@ static void *read_index(gzFile f, size_t size, const void *start, int max_index)
     }
 
     if (index < 0 || index > max_index) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: bad index", __func__);
     }
 
@@ -710,31 +823,45 @@ static void *read_index(gzFile f, size_t size, const void *start, int max_index)
     return p;
 }
 
-static void *read_pointer(gzFile f, ptr_type_t type)
+static void *read_pointer(savebuf_t *f, ptr_type_t type)
 {
     int index;
     const save_ptr_t *ptr;
 
-    index = read_int(f);
-    if (index == -1) {
-        return NULL;
+    if (f->ptrs) {
+        index = read_short(f);
+        if (index == -1) {
+            return NULL;
+        }
+
+        if (index < 0 || index >= f->numptrs) {
+            free_buffer(f);
+            gi.error("%s: bad table index", __func__);
+        }
+
+        index = f->ptrs[index];
+    } else {
+        index = read_int(f);
+        if (index == -1) {
+            return NULL;
+        }
     }
 
     if (index < 0 || index >= num_save_ptrs) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: bad index", __func__);
     }
 
     ptr = &save_ptrs[index];
     if (ptr->type != type) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("%s: type mismatch", __func__);
     }
 
     return (void *)ptr->ptr;
 }
 
-static void read_field(gzFile f, const save_field_t *field, void *base)
+static void read_field(savebuf_t *f, const save_field_t *field, void *base)
 {
     void *p = (byte *)base + field->ofs;
     int i;
@@ -793,7 +920,7 @@ static void read_field(gzFile f, const save_field_t *field, void *base)
     }
 }
 
-static void read_fields(gzFile f, const save_field_t *fields, void *base)
+static void read_fields(savebuf_t *f, const save_field_t *fields, void *base)
 {
     const save_field_t *field;
 
@@ -812,6 +939,26 @@ static void read_fields(gzFile f, const save_field_t *fields, void *base)
 #define SAVE_VERSION    8
 #endif
 
+// level savegames with entities in blocks and pointer table
+#define SAVE_VERSION_BLOCKS     (SAVE_VERSION + 1)
+
+// savegames are wrapped into a single block. server compresses them on
+// a worker thread, so new savegames are always stored. older savegames
+// are gzip streams without any header.
+#define SAVE_FILE_MAGIC     MakeLittleLong('S','V','B','1')
+
+enum {
+    SAVE_STORED,
+    SAVE_DEFLATED
+};
+
+typedef struct {
+    uint32_t    magic;
+    uint32_t    method;
+    uint32_t    size;
+    uint32_t    csize;
+} save_header_t;
+
 static void check_gzip(int magic)
 {
 #if !USE_ZLIB
@@ -820,6 +967,129 @@ static void check_gzip(int magic)
 #endif
 }
 
+/*
+============
+write_file
+
+Writes the whole savegame snapshot out with a single call, uncompressed.
+Frees the buffer.
+============
+*/
+static void write_file(savebuf_t *f, const char *filename)
+{
+    save_header_t header;
+    FILE    *fp;
+    bool    ok;
+
+    header.magic = LittleLong(SAVE_FILE_MAGIC);
+    header.method = LittleLong(SAVE_STORED);
+    header.size = LittleLong(f->cursize);
+    header.csize = LittleLong(f->cursize);
+
+    fp = fopen(filename, "wb");
+    ok = fp && fwrite(&header, sizeof(header), 1, fp) == 1 && fwrite(f->data, 1, f->cursize, fp) == f->cursize;
+    if (fp && fclose(fp))
+        ok = false;
+
+    free_buffer(f);
+
+    if (!fp)
+        gi.error("Couldn't open %s", filename);
+    if (!ok)
+        gi.error("Couldn't write %s", filename);
+}
+
+static void uncompress_file(savebuf_t *f)
+{
+    save_header_t header;
+    size_t  size;
+    byte    *data;
+
+    if (f->cursize < sizeof(header))
+        return;
+
+    memcpy(&header, f->data, sizeof(header));
+    if (LittleLong(header.magic) != SAVE_FILE_MAGIC)
+        return;
+
+    size = LittleLong(header.size);
+
+    if (LittleLong(header.csize) != f->cursize - sizeof(header)) {
+        free_buffer(f);
+        gi.error("Savegame is truncated");
+    }
+
+    data = gi.TagMalloc(size, TAG_GAME);
+
+    switch (LittleLong(header.method)) {
+    case SAVE_STORED:
+        if (size != f->cursize - sizeof(header))
+            goto fail;
+        memcpy(data, f->data + sizeof(header), size);
+        break;
+#if USE_ZLIB
+    case SAVE_DEFLATED: {
+        uLongf  len = size;
+        if (uncompress(data, &len, f->data + sizeof(header), f->cursize - sizeof(header)) != Z_OK || len != size)
+            goto fail;
+        }
+        break;
+#endif
+    default:
+        goto fail;
+    }
+
+    gi.TagFree(f->data);
+    f->data = data;
+    f->maxsize = f->cursize = size;
+    return;
+
+fail:
+    gi.TagFree(data);
+    free_buffer(f);
+    gi.error("Couldn't decompress savegame");
+}
+
+/*
+============
+read_file
+
+Reads the whole savegame into memory. Old gzip savegames are
+decompressed on the fly.
+============
+*/
+static savebuf_t *read_file(const char *filename)
+{
+    savebuf_t *f;
+    gzFile  fp;
+    int     ret;
+
+    fp = gzopen(filename, "rb");
+    if (!fp)
+        gi.error("Couldn't open %s", filename);
+
+    gzbuffer(fp, 65536);
+
+    f = alloc_buffer();
+    do {
+        grow_buffer(f, 1);
+        ret = gzread(fp, f->data + f->cursize, f->maxsize - f->cursize);
+        if (ret > 0)
+            f->cursize += ret;
+    } while (ret > 0);
+
+    gzclose(fp);
+
+    if (ret < 0) {
+        free_buffer(f);
+        gi.error("Couldn't read %s", filename);
+    }
+
+    uncompress_file(f);
+
+    return f;
+}
+
 /*
 ============
 WriteGame
@@ -836,15 +1106,13 @@ last save position.
 */
 void WriteGame(const char *filename, qboolean autosave)
 {
-    gzFile  f;
+    savebuf_t *f;
     int     i;
 
     if (!autosave)
         SaveClientData();
 
-    f = gzopen(filename, "wb");
-    if (!f)
-        gi.error("Couldn't open %s", filename);
+    f = alloc_buffer();
 
     write_int(f, SAVE_MAGIC1);
     write_int(f, SAVE_VERSION);
@@ -857,33 +1125,28 @@ void WriteGame(const char *filename, qboolean autosave)
         write_fields(f, clientfields, &game.clients[i]);
     }
 
-    if (gzclose(f))
-        gi.error("Couldn't write %s", filename);
+    write_file(f, filename);
 }
 
 void ReadGame(const char *filename)
 {
-    gzFile  f;
+    savebuf_t *f;
     int     i;
 
     gi.FreeTags(TAG_GAME);
 
-    f = gzopen(filename, "rb");
-    if (!f)
-        gi.error("Couldn't open %s", filename);
-
-    gzbuffer(f, 65536);
+    f = read_file(filename);
 
     i = read_int(f);
     if (i != SAVE_MAGIC1) {
-        gzclose(f);
+        free_buffer(f);
         check_gzip(i);
         gi.error("Not a Q2PRO save game");
     }
 
     i = read_int(f);
     if (i != SAVE_VERSION) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("Savegame from different version (got %d, expected %d)", i, SAVE_VERSION);
     }
 
@@ -891,24 +1154,26 @@ void ReadGame(const char *filename)
 
     // should agree with server's version
     if (game.maxclients != (int)maxclients->value) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("Savegame has bad maxclients");
     }
     if (game.maxentities <= game.maxclients || game.maxentities > game.csr.max_edicts) {
-        gzclose(f);
+        free_buffer(f);
         gi.error("Savegame has bad maxentities");
     }
 
     g_edicts = gi.TagMalloc(game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
     globals.edicts = g_edicts;
     globals.max_edicts = game.maxentities;
+    G_InitEntitySchedule();
+    G_InitEntityIndex();
 
     game.clients = gi.TagMalloc(game.maxclients * sizeof(game.clients[0]), TAG_GAME);
     for (i = 0; i < game.maxclients; i++) {
         read_fields(f, clientfields, &game.clients[i]);
     }
 
-    gzclose(f);
+    free_buffer(f);
 }
 
 //==========================================================
@@ -917,36 +1182,110 @@ void ReadGame(const char *filename)
 =================
 WriteLevel
 
+Layout is header, offset of pointer table, level locals, then blocks of
+consecutive entities in use, each preceded by number of the first entity
+and entity count. Pointer table goes last, when all used pointers are
+known. Function pointers in entities are 16-bit indices into this table.
 =================
 */
 void WriteLevel(const char *filename)
 {
-    int     i;
-    edict_t *ent;
-    gzFile  f;
+    int     i, j;
+    size_t  ofs;
+    savebuf_t *f;
 
-    f = gzopen(filename, "wb");
-    if (!f)
-        gi.error("Couldn't open %s", filename);
+    f = alloc_buffer();
+    f->ptrs = gi.TagMalloc(num_save_ptrs * sizeof(f->ptrs[0]), TAG_GAME);
+    f->ptrmap = gi.TagMalloc(num_save_ptrs * sizeof(f->ptrmap[0]), TAG_GAME);
 
     write_int(f, SAVE_MAGIC2);
-    write_int(f, SAVE_VERSION);
+    write_int(f, SAVE_VERSION_BLOCKS);
+
+    ofs = f->cursize;
+    write_int(f, 0);
 
     // write out level_locals_t
     write_fields(f, levelfields, &level);
 
     // write out all the entities
-    for (i = 0; i < globals.num_edicts; i++) {
-        ent = &g_edicts[i];
-        if (!ent->inuse)
+    for (i = 0; i < globals.num_edicts; i = j) {
+        if (!g_edicts[i].inuse) {
+            j = i + 1;
             continue;
+        }
+        for (j = i + 1; j < globals.num_edicts && g_edicts[j].inuse; j++)
+            ;
         write_int(f, i);
-        write_fields(f, entityfields, ent);
+        write_int(f, j - i);
+        for (; i < j; i++)
+            write_fields(f, entityfields, &g_edicts[i]);
     }
     write_int(f, -1);
 
-    if (gzclose(f))
-        gi.error("Couldn't write %s", filename);
+    // write out pointer table
+    patch_int(f, ofs, f->cursize);
+    write_int(f, f->numptrs);
+    for (i = 0; i < f->numptrs; i++) {
+        write_short(f, f->ptrs[i]);
+        write_short(f, save_ptrs[f->ptrs[i]].type);
+    }
+
+    write_file(f, filename);
+}
+
+static void read_pointer_table(savebuf_t *f)
+{
+    size_t  readcount;
+    int     i, ofs, index;
+
+    ofs = read_int(f);
+    if (ofs < f->readcount || ofs > f->cursize) {
+        free_buffer(f);
+        gi.error("%s: bad offset", __func__);
+    }
+
+    readcount = f->readcount;
+    f->readcount = ofs;
+
+    f->numptrs = read_int(f);
+    if (f->numptrs < 0 || f->numptrs > num_save_ptrs) {
+        free_buffer(f);
+        gi.error("%s: bad number of pointers", __func__);
+    }
+
+    // allocate at least one, non-NULL ptrs selects table lookup
+    f->ptrs = gi.TagMalloc((f->numptrs + 1) * sizeof(f->ptrs[0]), TAG_GAME);
+    for (i = 0; i < f->numptrs; i++) {
+        index = read_short(f);
+        if (index < 0 || index >= num_save_ptrs || save_ptrs[index].type != read_short(f)) {
+            free_buffer(f);
+            gi.error("%s: pointer table mismatch", __func__);
+        }
+        f->ptrs[i] = index;
+    }
+
+    f->readcount = readcount;
+}
+
+static void read_entity(savebuf_t *f, int entnum)
+{
+    edict_t *ent;
+
+    if (entnum < 0 || entnum >= game.maxentities) {
+        free_buffer(f);
+        gi.error("%s: bad entity number", __func__);
+    }
+    if (entnum >= globals.num_edicts)
+        globals.num_edicts = entnum + 1;
+
+    ent = &g_edicts[entnum];
+    read_fields(f, entityfields, ent);
+    ent->inuse = true;
+    ent->s.number = entnum;
+
+    // let the server rebuild world links for this ent
+    memset(&ent->area, 0, sizeof(ent->area));
+    gi.linkentity(ent);
 }
 
 /*
@@ -967,8 +1306,8 @@ No clients are connected yet.
 */
 void ReadLevel(const char *filename)
 {
-    int     entnum;
-    gzFile  f;
+    int     entnum, count, version;
+    savebuf_t *f;
     int     i;
     edict_t *ent;
 
@@ -976,29 +1315,29 @@ void ReadLevel(const char *filename)
     // base state
     gi.FreeTags(TAG_LEVEL);
 
-    f = gzopen(filename, "rb");
-    if (!f)
-        gi.error("Couldn't open %s", filename);
-
-    gzbuffer(f, 65536);
+    f = read_file(filename);
 
     // wipe all the entities
     memset(g_edicts, 0, game.maxentities * sizeof(g_edicts[0]));
     globals.num_edicts = game.maxclients + 1;
+    G_ResetEntitySchedule();
 
     i = read_int(f);
     if (i != SAVE_MAGIC2) {
-        gzclose(f);
+        free_buffer(f);
         check_gzip(i);
         gi.error("Not a Q2PRO save game");
     }
 
-    i = read_int(f);
-    if (i != SAVE_VERSION) {
-        gzclose(f);
-        gi.error("Savegame from different version (got %d, expected %d)", i, SAVE_VERSION);
+    version = read_int(f);
+    if (version != SAVE_VERSION && version != SAVE_VERSION_BLOCKS) {
+        free_buffer(f);
+        gi.error("Savegame from different version (got %d, expected %d)", version, SAVE_VERSION_BLOCKS);
     }
 
+    if (version == SAVE_VERSION_BLOCKS)
+        read_pointer_table(f);
+
     // load the level locals
     read_fields(f, levelfields, &level);
 
@@ -1007,24 +1346,20 @@ void ReadLevel(const char *filename)
         entnum = read_int(f);
         if (entnum == -1)
             break;
-        if (entnum < 0 || entnum >= game.maxentities) {
-            gzclose(f);
-            gi.error("%s: bad entity number", __func__);
+        if (version == SAVE_VERSION) {
+            read_entity(f, entnum);
+            continue;
         }
-        if (entnum >= globals.num_edicts)
-            globals.num_edicts = entnum + 1;
-
-        ent = &g_edicts[entnum];
-        read_fields(f, entityfields, ent);
-        ent->inuse = true;
-        ent->s.number = entnum;
-
-        // let the server rebuild world links for this ent
-        memset(&ent->area, 0, sizeof(ent->area));
-        gi.linkentity(ent);
+        count = read_int(f);
+        if (count < 1 || count > game.maxentities) {
+            free_buffer(f);
+            gi.error("%s: bad entity count", __func__);
+        }
+        for (i = 0; i < count; i++)
+            read_entity(f, entnum + i);
     }
 
-    gzclose(f);
+    free_buffer(f);
 
     // mark all clients as unconnected
     for (i = 0; i < game.maxclients; i++) {
@@ -1033,6 +1368,8 @@ void ReadLevel(const char *filename)
         ent->client->pers.connected = false;
     }
 
+    G_ResetEntityIndex();
+
     // do any load time things at this point
     for (i = 0; i < globals.num_edicts; i++) {
         ent = &g_edicts[i];
@@ -1043,7 +1380,7 @@ void ReadLevel(const char *filename)
         // fire any cross-level triggers
         if (ent->classname)
             if (strcmp(ent->classname, "target_crosslevel_target") == 0)
-                ent->nextthink = level.framenum + ent->delay * BASE_FRAMERATE;
+                G_SetNextThink(ent, level.framenum + ent->delay * BASE_FRAMERATE);
 
         if (ent->think == func_clock_think || ent->use == func_clock_use) {
             char *msg = ent->message;
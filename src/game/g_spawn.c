@@ -29,6 +29,17 @@ typedef struct {
     fieldtype_t type;
 } spawn_field_t;
 
+typedef struct {
+    const char          *name;
+    const spawn_field_t *field;
+    const spawn_func_t  *func;
+    const gitem_t       *item;
+} spawn_hash_t;
+
+// sizes must be powers of two and larger than the tables they hash
+#define FIELD_HASH_SIZE     64
+#define CLASS_HASH_SIZE     512
+
 void SP_item_health(edict_t *self);
 void SP_item_health_small(edict_t *self);
 void SP_item_health_large(edict_t *self);
@@ -331,43 +342,121 @@ static const spawn_field_t temp_fields[] = {
     { NULL }
 };
 
+static spawn_hash_t spawn_field_hash[FIELD_HASH_SIZE];
+static spawn_hash_t temp_field_hash[FIELD_HASH_SIZE];
+static spawn_hash_t classname_hash[CLASS_HASH_SIZE];
+
+static unsigned ED_HashKey(const char *s, bool icase)
+{
+    unsigned    hash = 2166136261U;
+
+    while (*s)
+        hash = (hash ^ (icase ? Q_tolower(*s++) : *s++)) * 16777619U;
+
+    return hash;
+}
+
+static spawn_hash_t *ED_HashSlot(spawn_hash_t *table, int size, const char *name, bool icase)
+{
+    unsigned    i = ED_HashKey(name, icase) & (size - 1);
+
+    while (table[i].name) {
+        if (icase ? !Q_stricmp(table[i].name, name) : !strcmp(table[i].name, name))
+            break;
+        i = (i + 1) & (size - 1);
+    }
+
+    return &table[i];
+}
+
+static spawn_hash_t *ED_HashInsert(spawn_hash_t *table, int size, const char *name, bool icase)
+{
+    spawn_hash_t *slot = ED_HashSlot(table, size, name, icase);
+
+    // first entry wins, like with linear search
+    if (slot->name)
+        return NULL;
+
+    slot->name = name;
+    return slot;
+}
+
+static void ED_HashFields(spawn_hash_t *table, const spawn_field_t *fields)
+{
+    spawn_hash_t *slot;
+
+    for (; fields->name; fields++)
+        if ((slot = ED_HashInsert(table, FIELD_HASH_SIZE, fields->name, true)))
+            slot->field = fields;
+}
+
 /*
 ===============
-ED_CallSpawn
+ED_InitSpawnHashes
 
-Finds the spawn function for the entity and calls it
+Builds lookup tables for spawn fields and spawn functions on first use.
+Items take precedence over normal spawn functions.
 ===============
 */
-void ED_CallSpawn(edict_t *ent)
+static void ED_InitSpawnHashes(void)
 {
+    static bool initialized;
     const spawn_func_t *s;
     const gitem_t *item;
+    spawn_hash_t *slot;
     int     i;
 
+    if (initialized)
+        return;
+
+    ED_HashFields(spawn_field_hash, spawn_fields);
+    ED_HashFields(temp_field_hash, temp_fields);
+
+    for (i = 0, item = itemlist; i < game.num_items; i++, item++) {
+        if (!item->classname)
+            continue;
+        if ((slot = ED_HashInsert(classname_hash, CLASS_HASH_SIZE, item->classname, false)))
+            slot->item = item;
+    }
+
+    for (s = spawn_funcs; s->name; s++)
+        if ((slot = ED_HashInsert(classname_hash, CLASS_HASH_SIZE, s->name, false)))
+            slot->func = s;
+
+    initialized = true;
+}
+
+/*
+===============
+ED_CallSpawn
+
+Finds the spawn function for the entity and calls it
+===============
+*/
+void ED_CallSpawn(edict_t *ent)
+{
+    const spawn_hash_t *slot;
+
     if (!ent->classname) {
         gi.dprintf("ED_CallSpawn: NULL classname\n");
         G_FreeEdict(ent);
         return;
     }
 
+    ED_InitSpawnHashes();
+
+    slot = ED_HashSlot(classname_hash, CLASS_HASH_SIZE, ent->classname, false);
+
     // check item spawn functions
-    for (i = 0, item = itemlist; i < game.num_items; i++, item++) {
-        if (!item->classname)
-            continue;
-        if (!strcmp(item->classname, ent->classname)) {
-            // found it
-            SpawnItem(ent, item);
-            return;
-        }
+    if (slot->item) {
+        SpawnItem(ent, slot->item);
+        return;
     }
 
     // check normal spawn functions
-    for (s = spawn_funcs; s->name; s++) {
-        if (!strcmp(s->name, ent->classname)) {
-            // found it
-            s->spawn(ent);
-            return;
-        }
+    if (slot->func) {
+        slot->func->spawn(ent);
+        return;
     }
 
     gi.dprintf("%s doesn't have a spawn function\n", ent->classname);
@@ -412,49 +501,47 @@ Takes a key/value pair and sets the binary values
 in an edict
 ===============
 */
-static bool ED_ParseField(const spawn_field_t *fields, const char *key, const char *value, byte *b)
+static bool ED_ParseField(spawn_hash_t *fields, const char *key, const char *value, byte *b)
 {
     const spawn_field_t *f;
     float   v;
     vec3_t  vec;
 
-    for (f = fields; f->name; f++) {
-        if (!Q_stricmp(f->name, key)) {
-            // found it
-            switch (f->type) {
-            case F_LSTRING:
-                *(char **)(b + f->ofs) = ED_NewString(value);
-                break;
-            case F_VECTOR:
-                if (sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]) != 3) {
-                    gi.dprintf("%s: couldn't parse '%s'\n", __func__, key);
-                    VectorClear(vec);
-                }
-                ((float *)(b + f->ofs))[0] = vec[0];
-                ((float *)(b + f->ofs))[1] = vec[1];
-                ((float *)(b + f->ofs))[2] = vec[2];
-                break;
-            case F_INT:
-                *(int *)(b + f->ofs) = Q_atoi(value);
-                break;
-            case F_FLOAT:
-                *(float *)(b + f->ofs) = Q_atof(value);
-                break;
-            case F_ANGLEHACK:
-                v = Q_atof(value);
-                ((float *)(b + f->ofs))[0] = 0;
-                ((float *)(b + f->ofs))[1] = v;
-                ((float *)(b + f->ofs))[2] = 0;
-                break;
-            case F_IGNORE:
-                break;
-            default:
-                break;
-            }
-            return true;
+    f = ED_HashSlot(fields, FIELD_HASH_SIZE, key, true)->field;
+    if (!f)
+        return false;
+
+    switch (f->type) {
+    case F_LSTRING:
+        *(char **)(b + f->ofs) = ED_NewString(value);
+        break;
+    case F_VECTOR:
+        if (sscanf(value, "%f %f %f", &vec[0], &vec[1], &vec[2]) != 3) {
+            gi.dprintf("%s: couldn't parse '%s'\n", __func__, key);
+            VectorClear(vec);
         }
+        ((float *)(b + f->ofs))[0] = vec[0];
+        ((float *)(b + f->ofs))[1] = vec[1];
+        ((float *)(b + f->ofs))[2] = vec[2];
+        break;
+    case F_INT:
+        *(int *)(b + f->ofs) = Q_atoi(value);
+        break;
+    case F_FLOAT:
+        *(float *)(b + f->ofs) = Q_atof(value);
+        break;
+    case F_ANGLEHACK:
+        v = Q_atof(value);
+        ((float *)(b + f->ofs))[0] = 0;
+        ((float *)(b + f->ofs))[1] = v;
+        ((float *)(b + f->ofs))[2] = 0;
+        break;
+    case F_IGNORE:
+        break;
+    default:
+        break;
     }
-    return false;
+    return true;
 }
 
 /*
@@ -497,8 +584,8 @@ static void ED_ParseEdict(const char **data, edict_t *ent)
         if (key[0] == '_')
             continue;
 
-        if (!ED_ParseField(spawn_fields, key, value, (byte *)ent)) {
-            if (!ED_ParseField(temp_fields, key, value, (byte *)&st)) {
+        if (!ED_ParseField(spawn_field_hash, key, value, (byte *)ent)) {
+            if (!ED_ParseField(temp_field_hash, key, value, (byte *)&st)) {
                 gi.dprintf("%s: %s is not a field\n", __func__, key);
             }
         }
@@ -615,6 +702,19 @@ static void G_FreePrecaches(void)
     game.precaches = NULL;
 }
 
+// wall clock time for load statistics, monotonic where available
+static uint64_t G_Microseconds(void)
+{
+    struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return ts.tv_sec * UINT64_C(1000000) + ts.tv_nsec / 1000;
+}
+
 /*
 ==============
 SpawnEntities
@@ -628,8 +728,9 @@ void SpawnEntities(const char *mapname, const char *entities, const char *spawnp
     edict_t     *ent;
     int         inhibit;
     char        *com_token;
-    int         i;
+    int         i, count;
     int         skill_level;
+    uint64_t    start, parse_time, spawn_time;
 
     skill_level = Q_clip(skill->value, 0, 3);
     if (skill->value != skill_level)
@@ -641,8 +742,12 @@ void SpawnEntities(const char *mapname, const char *entities, const char *spawnp
 
     G_FreePrecaches();
 
+    ED_InitSpawnHashes();
+
     memset(&level, 0, sizeof(level));
     memset(g_edicts, 0, game.maxentities * sizeof(g_edicts[0]));
+    G_ResetEntitySchedule();
+    G_ResetEntityIndex();
 
     Q_strlcpy(level.mapname, mapname, sizeof(level.mapname));
     Q_strlcpy(game.spawnpoint, spawnpoint, sizeof(game.spawnpoint));
@@ -653,9 +758,13 @@ void SpawnEntities(const char *mapname, const char *entities, const char *spawnp
 
     ent = NULL;
     inhibit = 0;
+    count = 0;
+    parse_time = spawn_time = 0;
 
 // parse ents
     while (1) {
+        start = G_Microseconds();
+
         // parse the opening brace
         com_token = COM_Parse(&entities);
         if (!entities)
@@ -668,6 +777,9 @@ void SpawnEntities(const char *mapname, const char *entities, const char *spawnp
         else
             ent = G_Spawn();
         ED_ParseEdict(&entities, ent);
+        G_IndexEntity(ent);
+
+        parse_time += G_Microseconds() - start;
 
         // yet another map hack
         if (!Q_stricmp(level.mapname, "command") && !Q_stricmp(ent->classname, "trigger_once") && !Q_stricmp(ent->model, "*27"))
@@ -696,12 +808,20 @@ void SpawnEntities(const char *mapname, const char *entities, const char *spawnp
             ent->spawnflags &= ~(SPAWNFLAG_NOT_EASY | SPAWNFLAG_NOT_MEDIUM | SPAWNFLAG_NOT_HARD | SPAWNFLAG_NOT_COOP | SPAWNFLAG_NOT_DEATHMATCH);
         }
 
+        start = G_Microseconds();
         ED_CallSpawn(ent);
+        spawn_time += G_Microseconds() - start;
+
+        // spawn functions free entities they reject
+        if (ent->inuse)
+            count++;
     }
 
     memset(&st, 0, sizeof(st));
 
     gi.dprintf("%i entities inhibited\n", inhibit);
+    gi.dprintf("%i entities spawned, %.1f ms parsing, %.1f ms spawning\n",
+               count, parse_time * 1e-3, spawn_time * 1e-3);
 
 #ifdef DEBUG
     i = 1;
@@ -243,7 +243,7 @@ void use_target_explosion(edict_t *self, edict_t *other, edict_t *activator)
     }
 
     self->think = target_explosion_explode;
-    self->nextthink = level.framenum + self->delay * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + self->delay * BASE_FRAMERATE);
 }
 
 void SP_target_explosion(edict_t *ent)
@@ -364,7 +364,7 @@ void use_target_spawner(edict_t *self, edict_t *other, edict_t *activator)
     edict_t *ent;
 
     ent = G_Spawn();
-    ent->classname = self->target;
+    G_SetClassname(ent, self->target);
     VectorCopy(self->s.origin, ent->s.origin);
     VectorCopy(self->s.angles, ent->s.angles);
     ED_CallSpawn(ent);
@@ -463,7 +463,7 @@ void SP_target_crosslevel_target(edict_t *self)
     self->svflags = SVF_NOCLIENT;
 
     self->think = target_crosslevel_target_think;
-    self->nextthink = level.framenum + self->delay * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + self->delay * BASE_FRAMERATE);
 }
 
 //==========================================================
@@ -531,7 +531,7 @@ void target_laser_think(edict_t *self)
 
     VectorCopy(tr.endpos, self->s.old_origin);
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 static void target_laser_on(edict_t *self)
@@ -547,7 +547,7 @@ static void target_laser_off(edict_t *self)
 {
     self->spawnflags &= ~1;
     self->svflags |= SVF_NOCLIENT;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
 }
 
 void target_laser_use(edict_t *self, edict_t *other, edict_t *activator)
@@ -616,7 +616,7 @@ void SP_target_laser(edict_t *self)
 {
     // let everything else get spawned before we start firing
     self->think = target_laser_start;
-    self->nextthink = level.framenum + 1 * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 1 * BASE_FRAMERATE);
 }
 
 //==========================================================
@@ -636,7 +636,7 @@ void target_lightramp_think(edict_t *self)
     gi.configstring(game.csr.lights + self->enemy->style, style);
 
     if (diff < self->speed) {
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     } else if (self->spawnflags & 1) {
         SWAP(float, self->movedir[0], self->movedir[1]);
         self->movedir[2] = -self->movedir[2];
@@ -735,13 +735,13 @@ void target_earthquake_think(edict_t *self)
     }
 
     if (level.framenum < self->timestamp)
-        self->nextthink = level.framenum + 0.1f * BASE_FRAMERATE;
+        G_SetNextThink(self, level.framenum + 0.1f * BASE_FRAMERATE);
 }
 
 void target_earthquake_use(edict_t *self, edict_t *other, edict_t *activator)
 {
     self->timestamp = level.framenum + self->count * BASE_FRAMERATE;
-    self->nextthink = level.framenum + 0.1f * BASE_FRAMERATE;
+    G_SetNextThink(self, level.framenum + 0.1f * BASE_FRAMERATE);
     self->activator = activator;
     self->last_move_framenum = 0;
 }
@@ -31,7 +31,7 @@ static void InitTrigger(edict_t *self)
 // the wait time has passed, so set back up for another activation
 void multi_wait(edict_t *ent)
 {
-    ent->nextthink = 0;
+    G_SetNextThink(ent, 0);
 }
 
 // the trigger was just activated
@@ -46,12 +46,12 @@ static void multi_trigger(edict_t *ent)
 
     if (ent->wait > 0) {
         ent->think = multi_wait;
-        ent->nextthink = level.framenum + ent->wait * BASE_FRAMERATE;
+        G_SetNextThink(ent, level.framenum + ent->wait * BASE_FRAMERATE);
     } else {
         // we can't just remove (self) here, because this is a touch function
         // called while looping through area links...
         ent->touch = NULL;
-        ent->nextthink = level.framenum + 1;
+        G_SetNextThink(ent, level.framenum + 1);
         ent->think = G_FreeEdict;
     }
 }
@@ -26,6 +26,227 @@ void G_ProjectSource(const vec3_t point, const vec3_t distance, const vec3_t for
     result[2] = point[2] + forward[2] * distance[0] + right[2] * distance[1] + distance[2];
 }
 
+/*
+=============================================================================
+
+ENTITY INDEX
+
+Entities are hashed by classname and targetname so that G_Find doesn't
+have to walk every edict. Each hash chain is kept sorted by entity number,
+which makes indexed searches visit entities in the same order as a linear
+scan would. Fields are indexed by the string pointer they held when last
+set through G_SetClassname / G_SetTargetname / G_IndexEntity.
+
+=============================================================================
+*/
+
+#define ENT_HASH_SIZE   1024
+
+typedef struct {
+    int         ofs;
+    char        **keys;     // string each entity is indexed by, or NULL
+    int         *hash;
+    int         *next, *prev;
+    int         heads[ENT_HASH_SIZE];
+    int         tails[ENT_HASH_SIZE];
+} entindex_t;
+
+static entindex_t   ent_index[2] = {
+    { .ofs = FOFS(classname) },
+    { .ofs = FOFS(targetname) },
+};
+
+static int G_HashEntityKey(const char *s)
+{
+    unsigned    hash = 2166136261U;
+
+    while (*s)
+        hash = (hash ^ Q_tolower(*s++)) * 16777619U;
+
+    return hash & (ENT_HASH_SIZE - 1);
+}
+
+static entindex_t *G_EntityIndexForField(int fieldofs)
+{
+    int     i;
+
+    for (i = 0; i < q_countof(ent_index); i++)
+        if (ent_index[i].ofs == fieldofs)
+            return &ent_index[i];
+
+    return NULL;
+}
+
+static void G_UnindexKey(entindex_t *index, int n)
+{
+    int hash = index->hash[n];
+
+    if (!index->keys[n])
+        return;
+
+    if (index->prev[n] == -1)
+        index->heads[hash] = index->next[n];
+    else
+        index->next[index->prev[n]] = index->next[n];
+
+    if (index->next[n] == -1)
+        index->tails[hash] = index->prev[n];
+    else
+        index->prev[index->next[n]] = index->prev[n];
+
+    index->keys[n] = NULL;
+    index->next[n] = index->prev[n] = -1;
+}
+
+static void G_IndexKey(entindex_t *index, int n, char *key)
+{
+    int hash, i;
+
+    if (index->keys[n] == key)
+        return;
+
+    G_UnindexKey(index, n);
+    if (!key)
+        return;
+
+    hash = G_HashEntityKey(key);
+
+    // entities are mostly spawned in ascending order, so search from the tail
+    for (i = index->tails[hash]; i > n; i = index->prev[i])
+        ;
+
+    index->prev[n] = i;
+    if (i == -1) {
+        index->next[n] = index->heads[hash];
+        index->heads[hash] = n;
+    } else {
+        index->next[n] = index->next[i];
+        index->next[i] = n;
+    }
+
+    if (index->next[n] == -1)
+        index->tails[hash] = n;
+    else
+        index->prev[index->next[n]] = n;
+
+    index->keys[n] = key;
+    index->hash[n] = hash;
+}
+
+static edict_t *G_FindIndexed(entindex_t *index, edict_t *from, const char *match)
+{
+    int     start, hash, i;
+    edict_t *e;
+    char    *s;
+
+    hash = G_HashEntityKey(match);
+    start = from ? from - g_edicts + 1 : 0;
+
+    // continue along the chain of the last match when possible
+    if (from && index->keys[start - 1] && index->hash[start - 1] == hash)
+        i = index->next[start - 1];
+    else
+        i = index->heads[hash];
+
+    for (; i != -1 && i < globals.num_edicts; i = index->next[i]) {
+        if (i < start)
+            continue;
+        e = &g_edicts[i];
+        if (!e->inuse)
+            continue;
+        s = *(char **)((byte *)e + index->ofs);
+        if (!s)
+            continue;
+        if (!Q_stricmp(s, match))
+            return e;
+    }
+
+    return NULL;
+}
+
+/*
+=============
+G_IndexEntity
+
+Updates entity index after indexed fields of the entity have been written
+directly, e.g. by the spawn parser.
+=============
+*/
+void G_IndexEntity(edict_t *ent)
+{
+    int     i;
+
+    for (i = 0; i < q_countof(ent_index); i++)
+        G_IndexKey(&ent_index[i], ent - g_edicts, *(char **)((byte *)ent + ent_index[i].ofs));
+}
+
+static void G_UnindexEntity(edict_t *ent)
+{
+    int     i;
+
+    for (i = 0; i < q_countof(ent_index); i++)
+        G_UnindexKey(&ent_index[i], ent - g_edicts);
+}
+
+void G_SetClassname(edict_t *ent, char *classname)
+{
+    ent->classname = classname;
+    G_IndexKey(&ent_index[0], ent - g_edicts, classname);
+}
+
+void G_SetTargetname(edict_t *ent, char *targetname)
+{
+    ent->targetname = targetname;
+    G_IndexKey(&ent_index[1], ent - g_edicts, targetname);
+}
+
+/*
+=============
+G_ResetEntityIndex
+
+Rebuilds entity index from scratch. Should be called after g_edicts has
+been wiped or loaded.
+=============
+*/
+void G_ResetEntityIndex(void)
+{
+    entindex_t  *index;
+    int         i;
+
+    for (i = 0, index = ent_index; i < q_countof(ent_index); i++, index++) {
+        memset(index->keys, 0, game.maxentities * sizeof(index->keys[0]));
+        memset(index->next, -1, game.maxentities * sizeof(index->next[0]));
+        memset(index->prev, -1, game.maxentities * sizeof(index->prev[0]));
+        memset(index->heads, -1, sizeof(index->heads));
+        memset(index->tails, -1, sizeof(index->tails));
+    }
+
+    for (i = 0; i < globals.num_edicts; i++)
+        G_IndexEntity(&g_edicts[i]);
+}
+
+/*
+=============
+G_InitEntityIndex
+
+Should be called after g_edicts has been allocated.
+=============
+*/
+void G_InitEntityIndex(void)
+{
+    entindex_t  *index;
+    int         i;
+
+    for (i = 0, index = ent_index; i < q_countof(ent_index); i++, index++) {
+        index->keys = gi.TagMalloc(game.maxentities * sizeof(index->keys[0]), TAG_GAME);
+        index->hash = gi.TagMalloc(game.maxentities * sizeof(index->hash[0]), TAG_GAME);
+        index->next = gi.TagMalloc(game.maxentities * sizeof(index->next[0]), TAG_GAME);
+        index->prev = gi.TagMalloc(game.maxentities * sizeof(index->prev[0]), TAG_GAME);
+    }
+
+    G_ResetEntityIndex();
+}
+
 /*
 =============
 G_Find
@@ -40,7 +261,12 @@ NULL will be returned if the end of the list is reached.
 */
 edict_t *G_Find(edict_t *from, int fieldofs, char *match)
 {
-    char    *s;
+    entindex_t  *index;
+    char        *s;
+
+    index = G_EntityIndexForField(fieldofs);
+    if (index)
+        return G_FindIndexed(index, from, match);
 
     if (!from)
         from = g_edicts;
@@ -67,29 +293,68 @@ findradius
 Returns entities that have origins within a spherical area
 
 findradius (origin, radius)
+
+Candidates are gathered from the world with BoxEdicts, so only linked
+entities are returned. The candidate list is gathered once when iteration
+starts with NULL and walked with a cursor by subsequent calls.
 =================
 */
+static struct {
+    vec3_t  org;
+    float   rad;
+    edict_t *last;
+    int     num, cursor;
+    edict_t *list[MAX_EDICTS_OLD];
+} radius;
+
+static int edictcmp(const void *p1, const void *p2)
+{
+    const edict_t *e1 = *(const edict_t **)p1;
+    const edict_t *e2 = *(const edict_t **)p2;
+
+    return (e1 > e2) - (e1 < e2);
+}
+
 edict_t *findradius(edict_t *from, vec3_t org, float rad)
 {
-    vec3_t  eorg;
-    vec3_t  mid;
+    vec3_t  mins, maxs, eorg, mid;
+    edict_t *e;
 
-    if (!from)
-        from = g_edicts;
-    else
-        from++;
-    for (; from < &g_edicts[globals.num_edicts]; from++) {
-        if (!from->inuse)
+    // start over if not continuing last iteration
+    if (!from || from != radius.last || rad != radius.rad || !VectorCompare(org, radius.org)) {
+        VectorSet(mins, org[0] - rad, org[1] - rad, org[2] - rad);
+        VectorSet(maxs, org[0] + rad, org[1] + rad, org[2] + rad);
+
+        radius.num = gi.BoxEdicts(mins, maxs, radius.list, q_countof(radius.list), AREA_SOLID);
+        radius.num += gi.BoxEdicts(mins, maxs, radius.list + radius.num,
+                                   q_countof(radius.list) - radius.num, AREA_TRIGGERS);
+
+        // return matches in entity order
+        qsort(radius.list, radius.num, sizeof(radius.list[0]), edictcmp);
+
+        VectorCopy(org, radius.org);
+        radius.rad = rad;
+        radius.cursor = 0;
+    }
+
+    // entities may have been freed since the list was gathered
+    while (radius.cursor < radius.num) {
+        e = radius.list[radius.cursor++];
+        if (from && e <= from)
+            continue;
+        if (!e->inuse)
             continue;
-        if (from->solid == SOLID_NOT)
+        if (e->solid == SOLID_NOT)
             continue;
-        VectorAvg(from->mins, from->maxs, mid);
-        VectorAdd(from->s.origin, mid, eorg);
+        VectorAvg(e->mins, e->maxs, mid);
+        VectorAdd(e->s.origin, mid, eorg);
         if (Distance(eorg, org) > rad)
             continue;
-        return from;
+        radius.last = e;
+        return e;
     }
 
+    radius.last = NULL;
     return NULL;
 }
 
@@ -167,8 +432,8 @@ void G_UseTargets(edict_t *ent, edict_t *activator)
     if (ent->delay) {
         // create a temp object to fire at a later time
         t = G_Spawn();
-        t->classname = "DelayedUse";
-        t->nextthink = level.framenum + ent->delay * BASE_FRAMERATE;
+        G_SetClassname(t, "DelayedUse");
+        G_SetNextThink(t, level.framenum + ent->delay * BASE_FRAMERATE);
         t->think = Think_Delay;
         t->activator = activator;
         if (!activator)
@@ -218,8 +483,10 @@ void G_UseTargets(edict_t *ent, edict_t *activator)
             if (t == ent) {
                 gi.dprintf("WARNING: Entity used itself.\n");
             } else {
-                if (t->use)
+                if (t->use) {
+                    G_WakeEntity(t);
                     t->use(t, ent, activator);
+                }
             }
             if (!ent->inuse) {
                 gi.dprintf("entity was removed while using targets\n");
@@ -309,9 +576,10 @@ char *G_CopyString(char *in)
 void G_InitEdict(edict_t *e)
 {
     e->inuse = true;
-    e->classname = "noclass";
+    G_SetClassname(e, "noclass");
     e->gravity = 1.0f;
     e->s.number = e - g_edicts;
+    G_WakeEntity(e);
 }
 
 /*
@@ -364,6 +632,7 @@ void G_FreeEdict(edict_t *ed)
         return;
     }
 
+    G_UnindexEntity(ed);
     memset(ed, 0, sizeof(*ed));
     ed->classname = "freed";
     ed->freetime = level.time;
@@ -395,6 +664,7 @@ void G_TouchTriggers(edict_t *ent)
             continue;
         if (!hit->touch)
             continue;
+        G_WakeEntity(hit);
         hit->touch(hit, ent, NULL, NULL);
     }
 }
@@ -338,10 +338,10 @@ void fire_blaster(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed
     bolt->s.sound = gi.soundindex("misc/lasfly.wav");
     bolt->owner = self;
     bolt->touch = blaster_touch;
-    bolt->nextthink = level.framenum + 2 * BASE_FRAMERATE;
+    G_SetNextThink(bolt, level.framenum + 2 * BASE_FRAMERATE);
     bolt->think = G_FreeEdict;
     bolt->dmg = damage;
-    bolt->classname = "bolt";
+    G_SetClassname(bolt, "bolt");
     if (hyper)
         bolt->spawnflags = 1;
     gi.linkentity(bolt);
@@ -467,11 +467,11 @@ void fire_grenade(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int sp
     grenade->s.modelindex = gi.modelindex("models/objects/grenade/tris.md2");
     grenade->owner = self;
     grenade->touch = Grenade_Touch;
-    grenade->nextthink = level.framenum + timer * BASE_FRAMERATE;
+    G_SetNextThink(grenade, level.framenum + timer * BASE_FRAMERATE);
     grenade->think = Grenade_Explode;
     grenade->dmg = damage;
     grenade->dmg_radius = damage_radius;
-    grenade->classname = "grenade";
+    G_SetClassname(grenade, "grenade");
 
     gi.linkentity(grenade);
 }
@@ -503,11 +503,11 @@ void fire_grenade2(edict_t *self, vec3_t start, vec3_t aimdir, int damage, int s
     grenade->s.modelindex = gi.modelindex("models/objects/grenade2/tris.md2");
     grenade->owner = self;
     grenade->touch = Grenade_Touch;
-    grenade->nextthink = level.framenum + timer * BASE_FRAMERATE;
+    G_SetNextThink(grenade, level.framenum + timer * BASE_FRAMERATE);
     grenade->think = Grenade_Explode;
     grenade->dmg = damage;
     grenade->dmg_radius = damage_radius;
-    grenade->classname = "hgrenade";
+    G_SetClassname(grenade, "hgrenade");
     if (held)
         grenade->spawnflags = 3;
     else
@@ -590,13 +590,13 @@ void fire_rocket(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed,
     rocket->s.modelindex = gi.modelindex("models/objects/rocket/tris.md2");
     rocket->owner = self;
     rocket->touch = rocket_touch;
-    rocket->nextthink = level.framenum + BASE_FRAMERATE * 8000 / speed;
+    G_SetNextThink(rocket, level.framenum + BASE_FRAMERATE * 8000 / speed);
     rocket->think = G_FreeEdict;
     rocket->dmg = damage;
     rocket->radius_dmg = radius_damage;
     rocket->dmg_radius = damage_radius;
     rocket->s.sound = gi.soundindex("weapons/rockfly.wav");
-    rocket->classname = "rocket";
+    G_SetClassname(rocket, "rocket");
 
     if (self->client)
         check_dodge(self, rocket->s.origin, dir, speed);
@@ -707,7 +707,7 @@ void bfg_explode(edict_t *self)
         }
     }
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->s.frame++;
     if (self->s.frame == 5)
         self->think = G_FreeEdict;
@@ -741,7 +741,7 @@ void bfg_touch(edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf)
     self->s.sound = 0;
     self->s.effects &= ~EF_ANIM_ALLFAST;
     self->think = bfg_explode;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->enemy = other;
 
     gi.WriteByte(svc_temp_entity);
@@ -821,7 +821,7 @@ void bfg_think(edict_t *self)
         gi.multicast(self->s.origin, MULTICAST_PHS);
     }
 
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
 }
 
 void fire_bfg(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed, float damage_radius)
@@ -842,15 +842,15 @@ void fire_bfg(edict_t *self, vec3_t start, vec3_t dir, int damage, int speed, fl
     bfg->s.modelindex = gi.modelindex("sprites/s_bfg1.sp2");
     bfg->owner = self;
     bfg->touch = bfg_touch;
-    bfg->nextthink = level.framenum + BASE_FRAMERATE * 8000 / speed;
+    G_SetNextThink(bfg, level.framenum + BASE_FRAMERATE * 8000 / speed);
     bfg->think = G_FreeEdict;
     bfg->radius_dmg = damage;
     bfg->dmg_radius = damage_radius;
-    bfg->classname = "bfg blast";
+    G_SetClassname(bfg, "bfg blast");
     bfg->s.sound = gi.soundindex("weapons/bfg__l1a.wav");
 
     bfg->think = bfg_think;
-    bfg->nextthink = level.framenum + 1;
+    G_SetNextThink(bfg, level.framenum + 1);
     bfg->teammaster = bfg;
     bfg->teamchain = NULL;
 
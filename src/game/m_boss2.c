@@ -459,7 +459,7 @@ static void boss2_dead(edict_t *self)
     VectorSet(self->maxs, 56, 56, 80);
     self->movetype = MOVETYPE_TOSS;
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
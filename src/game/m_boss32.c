@@ -584,10 +584,10 @@ Makron Torso. This needs to be spawned in
 void makron_torso_think(edict_t *self)
 {
     if (++self->s.frame < 365)
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     else {
         self->s.frame = 346;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -600,7 +600,7 @@ static void makron_torso(edict_t *ent)
     ent->s.frame = 346;
     ent->s.modelindex = gi.modelindex("models/monsters/boss3/rider/tris.md2");
     ent->think = makron_torso_think;
-    ent->nextthink = level.framenum + 2;
+    G_SetNextThink(ent, level.framenum + 2);
     ent->s.sound = gi.soundindex("makron/spine.wav");
     gi.linkentity(ent);
 }
@@ -615,7 +615,7 @@ static void makron_dead(edict_t *self)
     VectorSet(self->maxs, 60, 60, 72);
     self->movetype = MOVETYPE_TOSS;
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -835,7 +835,7 @@ void MakronToss(edict_t *self)
     edict_t *ent;
 
     ent = G_Spawn();
-    ent->nextthink = level.framenum + 0.8f * BASE_FRAMERATE;
+    G_SetNextThink(ent, level.framenum + 0.8f * BASE_FRAMERATE);
     ent->think = MakronSpawn;
     ent->target = self->target;
     VectorCopy(self->s.origin, ent->s.origin);
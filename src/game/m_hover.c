@@ -487,7 +487,7 @@ void hover_pain(edict_t *self, edict_t *other, float kick, int damage)
 void hover_deadthink(edict_t *self)
 {
     if (!self->groundentity && level.framenum < self->timestamp) {
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
         return;
     }
     BecomeExplosion1(self);
@@ -499,7 +499,7 @@ static void hover_dead(edict_t *self)
     VectorSet(self->maxs, 16, 16, -8);
     self->movetype = MOVETYPE_TOSS;
     self->think = hover_deadthink;
-    self->nextthink = level.framenum + 1;
+    G_SetNextThink(self, level.framenum + 1);
     self->timestamp = level.framenum + 15 * BASE_FRAMERATE;
     gi.linkentity(self);
 }
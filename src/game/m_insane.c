@@ -539,7 +539,7 @@ static void insane_dead(edict_t *self)
         self->movetype = MOVETYPE_TOSS;
     }
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
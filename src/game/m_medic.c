@@ -345,7 +345,7 @@ static void medic_dead(edict_t *self)
     VectorSet(self->maxs, 16, 16, -8);
     self->movetype = MOVETYPE_TOSS;
     self->svflags |= SVF_DEADMONSTER;
-    self->nextthink = 0;
+    G_SetNextThink(self, 0);
     gi.linkentity(self);
 }
 
@@ -573,14 +573,14 @@ static void medic_cable_attack(edict_t *self)
         self->enemy->spawnflags = 0;
         self->enemy->monsterinfo.aiflags = 0;
         self->enemy->target = NULL;
-        self->enemy->targetname = NULL;
+        G_SetTargetname(self->enemy, NULL);
         self->enemy->combattarget = NULL;
         self->enemy->deathtarget = NULL;
         self->enemy->owner = self;
         ED_CallSpawn(self->enemy);
         self->enemy->owner = NULL;
         if (self->enemy->think) {
-            self->enemy->nextthink = level.framenum;
+            G_SetNextThink(self->enemy, level.framenum);
             self->enemy->think(self->enemy);
         }
         self->enemy->monsterinfo.aiflags |= AI_RESURRECTING;
@@ -49,7 +49,7 @@ void SP_FixCoopSpots(edict_t *self)
         if (VectorLength(d) < 384) {
             if ((!self->targetname) || Q_stricmp(self->targetname, spot->targetname) != 0) {
 //              gi.dprintf("FixCoopSpots changed %s at %s targetname from %s to %s\n", self->classname, vtos(self->s.origin), self->targetname, spot->targetname);
-                self->targetname = spot->targetname;
+                G_SetTargetname(self, spot->targetname);
             }
             return;
         }
@@ -66,27 +66,27 @@ void SP_CreateCoopSpots(edict_t *self)
 
     if (Q_stricmp(level.mapname, "security") == 0) {
         spot = G_Spawn();
-        spot->classname = "info_player_coop";
+        G_SetClassname(spot, "info_player_coop");
         spot->s.origin[0] = 188 - 64;
         spot->s.origin[1] = -164;
         spot->s.origin[2] = 80;
-        spot->targetname = "jail3";
+        G_SetTargetname(spot, "jail3");
         spot->s.angles[1] = 90;
 
         spot = G_Spawn();
-        spot->classname = "info_player_coop";
+        G_SetClassname(spot, "info_player_coop");
         spot->s.origin[0] = 188 + 64;
         spot->s.origin[1] = -164;
         spot->s.origin[2] = 80;
-        spot->targetname = "jail3";
+        G_SetTargetname(spot, "jail3");
         spot->s.angles[1] = 90;
 
         spot = G_Spawn();
-        spot->classname = "info_player_coop";
+        G_SetClassname(spot, "info_player_coop");
         spot->s.origin[0] = 188 + 128;
         spot->s.origin[1] = -164;
         spot->s.origin[2] = 80;
-        spot->targetname = "jail3";
+        G_SetTargetname(spot, "jail3");
         spot->s.angles[1] = 90;
 
         return;
@@ -103,7 +103,7 @@ void SP_info_player_start(edict_t *self)
     if (Q_stricmp(level.mapname, "security") == 0) {
         // invoke one of our gross, ugly, disgusting hacks
         self->think = SP_CreateCoopSpots;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -146,7 +146,7 @@ void SP_info_player_coop(edict_t *self)
         (Q_stricmp(level.mapname, "strike") == 0)) {
         // invoke one of our gross, ugly, disgusting hacks
         self->think = SP_FixCoopSpots;
-        self->nextthink = level.framenum + 1;
+        G_SetNextThink(self, level.framenum + 1);
     }
 }
 
@@ -420,7 +420,7 @@ static void TossClientWeapon(edict_t *self)
         drop->spawnflags |= DROPPED_PLAYER_ITEM;
 
         drop->touch = Touch_Item;
-        drop->nextthink = self->client->quad_framenum;
+        G_SetNextThink(drop, self->client->quad_framenum);
         drop->think = G_FreeEdict;
     }
 }
@@ -853,7 +853,7 @@ void InitBodyQue(void)
     level.body_que = 0;
     for (i = 0; i < BODY_QUEUE_SIZE; i++) {
         ent = G_Spawn();
-        ent->classname = "bodyque";
+        G_SetClassname(ent, "bodyque");
     }
 }
 
@@ -1105,7 +1105,7 @@ static void PutClientInServer(edict_t *ent)
     ent->movetype = MOVETYPE_WALK;
     ent->viewheight = 22;
     ent->inuse = true;
-    ent->classname = "player";
+    G_SetClassname(ent, "player");
     ent->mass = 200;
     ent->solid = SOLID_BBOX;
     ent->deadflag = DEAD_NO;
@@ -1277,7 +1277,7 @@ void ClientBegin(edict_t *ent)
         // except for the persistent data that was initialized at
         // ClientConnect() time
         G_InitEdict(ent);
-        ent->classname = "player";
+        G_SetClassname(ent, "player");
         InitClientResp(ent->client);
         PutClientInServer(ent);
 
@@ -1476,7 +1476,7 @@ void ClientDisconnect(edict_t *ent)
     ent->s.solid = 0;
     ent->solid = SOLID_NOT;
     ent->inuse = false;
-    ent->classname = "disconnected";
+    G_SetClassname(ent, "disconnected");
     ent->client->pers.connected = false;
 
     // FIXME: don't break skins on corpses, etc
@@ -1619,6 +1619,7 @@ void ClientThink(edict_t *ent, usercmd_t *ucmd)
                 continue;   // duplicated
             if (!other->touch)
                 continue;
+            G_WakeEntity(other);
             other->touch(other, ent, NULL, NULL);
         }
 
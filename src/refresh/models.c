@@ -2204,7 +2204,7 @@ qhandle_t R_RegisterModel(const char *name)
     qhandle_t index;
     size_t namelen;
     model_t *model;
-    byte *rawdata;
+    const byte *rawdata;
     int (*load)(model_t *, const void *, size_t);
     int ret;
 
@@ -2242,7 +2242,7 @@ qhandle_t R_RegisterModel(const char *name)
         goto done;
     }
 
-    ret = FS_LoadFile(normalized, (void **)&rawdata);
+    ret = FS_MapFile(normalized, (const void **)&rawdata);
     if (!rawdata)
         goto fail1;
 
@@ -2262,7 +2262,7 @@ qhandle_t R_RegisterModel(const char *name)
 #endif
 
     if (!recognized) {
-        switch (LittleLong(*(uint32_t *)rawdata)) {
+        switch (RL32(rawdata)) {
         case MD2_IDENT:
             load = MOD_LoadMD2;
             break;
@@ -2291,7 +2291,7 @@ qhandle_t R_RegisterModel(const char *name)
 
     ret = load(model, rawdata, ret);
 
-    FS_FreeFile(rawdata);
+    FS_UnmapFile(rawdata);
 
     if (ret < 0) {
         MOD_Free(model);
@@ -2322,7 +2322,7 @@ done:
     return index;
 
 fail2:
-    FS_FreeFile(rawdata);
+    FS_UnmapFile(rawdata);
 fail1:
     MOD_PrintError(normalized, ret);
 
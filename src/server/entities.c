@@ -523,35 +523,32 @@ static bool SV_EntityAttenuatedAway(const vec3_t org, const edict_t *ent)
 #define IS_MONSTER(ent) \
     ((ent->svflags & (SVF_MONSTER | SVF_DEADMONSTER)) == SVF_MONSTER || (ent->s.renderfx & RF_FRAMELERP))
 
-#define IS_HI_PRIO(ent) \
-    (ent->s.number <= sv_client->maxclients || IS_MONSTER(ent) || ent->solid == SOLID_BSP)
+#define IS_HI_PRIO(client, ent) \
+    (ent->s.number <= client->maxclients || IS_MONSTER(ent) || ent->solid == SOLID_BSP)
 
-#define IS_GIB(ent) \
-    (sv_client->csr->extended ? (ent->s.renderfx & RF_LOW_PRIORITY) : (ent->s.effects & (EF_GIB | EF_GREENGIB)))
+#define IS_GIB(client, ent) \
+    (client->csr->extended ? (ent->s.renderfx & RF_LOW_PRIORITY) : (ent->s.effects & (EF_GIB | EF_GREENGIB)))
 
-#define IS_LO_PRIO(ent) \
-    (IS_GIB(ent) || (!ent->s.modelindex && !ent->s.effects))
+#define IS_LO_PRIO(client, ent) \
+    (IS_GIB(client, ent) || (!ent->s.modelindex && !ent->s.effects))
 
-static vec3_t clientorg;
+// sort key for entity prioritization. computed upfront so that comparison
+// doesn't depend on global state and frames can be built in parallel.
+typedef struct {
+    edict_t *ent;
+    int     prio;   // high priority first, low priority last
+    float   dist;
+} entprio_t;
 
 static int entpriocmp(const void *p1, const void *p2)
 {
-    const edict_t *a = *(const edict_t **)p1;
-    const edict_t *b = *(const edict_t **)p2;
+    const entprio_t *a = p1;
+    const entprio_t *b = p2;
 
-    bool hi_a = IS_HI_PRIO(a);
-    bool hi_b = IS_HI_PRIO(b);
-    if (hi_a != hi_b)
-        return hi_b - hi_a;
+    if (a->prio != b->prio)
+        return a->prio - b->prio;
 
-    bool lo_a = IS_LO_PRIO(a);
-    bool lo_b = IS_LO_PRIO(b);
-    if (lo_a != lo_b)
-        return lo_a - lo_b;
-
-    float dist_a = DistanceSquared(a->s.origin, clientorg);
-    float dist_b = DistanceSquared(b->s.origin, clientorg);
-    if (dist_a > dist_b)
+    if (a->dist > b->dist)
         return 1;
     return -1;
 }
@@ -585,8 +582,9 @@ void SV_BuildClientFrame(client_t *client)
     visrow_t    clientphs;
     visrow_t    clientpvs;
     int         max_packet_entities;
-    edict_t     *edicts[MAX_EDICTS];
+    edict_t     **edicts;
     int         num_edicts;
+    size_t      mark;
     qboolean (*visible)(edict_t *, edict_t *) = NULL;
     qboolean (*customize)(edict_t *, edict_t *, customize_entity_t *) = NULL;
     customize_entity_t temp;
@@ -654,6 +652,8 @@ void SV_BuildClientFrame(client_t *client)
     frame->num_entities = 0;
     frame->first_entity = client->next_entity;
 
+    mark = Z_FrameMark();
+    edicts = Z_FrameAlloc(sizeof(edicts[0]) * client->ge->num_edicts);
     num_edicts = 0;
     for (e = 1; e < client->ge->num_edicts; e++) {
         ent = EDICT_NUM2(client->ge, e);
@@ -733,13 +733,19 @@ void SV_BuildClientFrame(client_t *client)
 
     // prioritize entities on overflow
     if (num_edicts > max_packet_entities) {
-        VectorCopy(org, clientorg);
-        sv_client = client;
-        sv_player = client->edict;
-        qsort(edicts, num_edicts, sizeof(edicts[0]), entpriocmp);
-        sv_client = NULL;
-        sv_player = NULL;
+        entprio_t *prio = Z_FrameAlloc(sizeof(*prio) * num_edicts);
+
+        for (i = 0; i < num_edicts; i++) {
+            ent = edicts[i];
+            prio[i].ent = ent;
+            prio[i].prio = (IS_HI_PRIO(client, ent) ? 0 : 2) + (IS_LO_PRIO(client, ent) ? 1 : 0);
+            prio[i].dist = DistanceSquared(ent->s.origin, org);
+        }
+
+        qsort(prio, num_edicts, sizeof(prio[0]), entpriocmp);
         num_edicts = max_packet_entities;
+        for (i = 0; i < num_edicts; i++)
+            edicts[i] = prio[i].ent;
         qsort(edicts, num_edicts, sizeof(edicts[0]), entnumcmp);
     }
 
@@ -788,4 +794,6 @@ void SV_BuildClientFrame(client_t *client)
         frame->num_entities++;
         client->next_entity++;
     }
+
+    Z_FrameRelease(mark);
 }
@@ -31,6 +31,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 const game_export_t     *ge;
 const game_q2pro_restart_filesystem_t *g_restart_fs;
 const game_q2pro_customize_entity_t   *g_customize_entity;
+const game_q2pro_binary_savegames_t  *g_binary_savegames;
 
 static void PF_configstring(int index, const char *val);
 
@@ -1066,6 +1067,7 @@ it is changing to a different game directory.
 void SV_ShutdownGameProgs(void)
 {
     g_restart_fs = NULL;
+    g_binary_savegames = NULL;
     if (ge) {
         ge->Shutdown();
         ge = NULL;
@@ -1145,9 +1147,11 @@ void SV_InitGameProgs(void)
     if (ge->GetExtension) {
         g_restart_fs = (game_q2pro_restart_filesystem_t *)ge->GetExtension(game_q2pro_restart_filesystem_ext);
         g_customize_entity = (game_q2pro_customize_entity_t *)ge->GetExtension(game_q2pro_customize_entity_ext);
+        g_binary_savegames = (game_q2pro_binary_savegames_t *)ge->GetExtension(game_q2pro_binary_savegames_ext);
     } else {
         g_restart_fs = NULL;
         g_customize_entity = NULL;
+        g_binary_savegames = NULL;
     }
 
     if (svs.game_api == Q2PROTO_GAME_VANILLA) {
@@ -30,6 +30,16 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #endif
 #include <stdlib.h>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#if defined(MFD_CLOEXEC)
+#define USE_MEMFD   1
+#else
+#define USE_MEMFD   0
+#endif
+
 static const cs_remap_t *game_csr;
 
 static game3_edict_t* translate_edict_to_game(edict_t* ent);
@@ -103,6 +113,22 @@ typedef struct {
 
 static game3_proxy_edict_t *server_edicts;
 
+// Edicts passed to imports since the last sync. Only these, clients and newly
+// allocated edicts are synced after ClientThink() and ClientCommand().
+static int dirty_edicts[MAX_EDICTS];
+static int num_dirty_edicts;
+static byte dirty_edicts_bits[MAX_EDICTS / CHAR_BIT];
+
+static cvar_t *sv_game3_fullsync;
+
+static void mark_edict_dirty(int index)
+{
+    if (Q_IsBitSet(dirty_edicts_bits, index))
+        return;
+    Q_SetBit(dirty_edicts_bits, index);
+    dirty_edicts[num_dirty_edicts++] = index;
+}
+
 static edict_t *translate_edict_from_game(game3_edict_t *ent)
 {
     assert(!ent || (ent >= GAME_EDICT_NUM(0) && ent < GAME_EDICT_NUM(game3_export->num_edicts)));
@@ -220,6 +246,7 @@ static void wrap_setmodel(game3_edict_t *gent, const char *name)
     game_export.num_edicts = game3_export->num_edicts;
 
     int ent_idx = NUM_FOR_GAME_EDICT(gent);
+    mark_edict_dirty(ent_idx);
     sync_single_edict_game_to_server(ent_idx);
     game_import.setmodel(translate_edict_from_game(gent), name);
     sync_single_edict_server_to_game(ent_idx);
@@ -264,6 +291,7 @@ static void wrap_positioned_sound(const vec3_t origin, game3_edict_t *gent, int
 static void wrap_unlinkentity(game3_edict_t *ent)
 {
     int ent_idx = NUM_FOR_GAME_EDICT(ent);
+    mark_edict_dirty(ent_idx);
     sync_single_edict_game_to_server(ent_idx);
     game_import.unlinkentity(translate_edict_from_game(ent));
     sync_single_edict_server_to_game(ent_idx);
@@ -274,6 +302,7 @@ static void wrap_linkentity(game3_edict_t *ent)
     game_export.num_edicts = game3_export->num_edicts;
 
     int ent_idx = NUM_FOR_GAME_EDICT(ent);
+    mark_edict_dirty(ent_idx);
     sync_single_edict_game_to_server(ent_idx);
     game_import.linkentity(translate_edict_from_game(ent));
     sync_single_edict_server_to_game(ent_idx);
@@ -480,6 +509,22 @@ static void sync_edicts_server_to_game(void)
     game3_export->num_edicts = game_export.num_edicts;
 }
 
+// Sync client edicts from server to game. Server doesn't change other edicts
+// between export calls except through imports, which sync them right away.
+static void sync_clients_server_to_game(void)
+{
+    if (sv_game3_fullsync->integer) {
+        sync_edicts_server_to_game();
+        return;
+    }
+
+    for (int i = 1; i <= sv_maxclients->integer && i < game_export.num_edicts; i++) {
+        sync_single_edict_server_to_game(i);
+    }
+
+    game3_export->num_edicts = game_export.num_edicts;
+}
+
 static void game_client_old_to_server(struct gclient_s *server_client, const struct game3_gclient_old_s *game_client)
 {
     ConvertFromGame3_pmove_state_old(&server_client->ps.pmove, &game_client->ps.pmove, game_csr->extended);
@@ -692,12 +737,47 @@ static void sync_edicts_game_to_server(void)
     }
 
     game_export.num_edicts = game3_export->num_edicts;
+
+    // everything is in sync now
+    memset(dirty_edicts_bits, 0, sizeof(dirty_edicts_bits));
+    num_dirty_edicts = 0;
+}
+
+// Sync clients, dirty and newly allocated edicts from game to server
+static void sync_dirty_edicts_game_to_server(int old_num_edicts)
+{
+    int i;
+
+    if (sv_game3_fullsync->integer) {
+        sync_edicts_game_to_server();
+        return;
+    }
+
+    for (i = 1; i <= sv_maxclients->integer && i < game3_export->num_edicts; i++) {
+        if (!Q_IsBitSet(dirty_edicts_bits, i))
+            sync_single_edict_game_to_server(i);
+    }
+
+    for (i = 0; i < num_dirty_edicts; i++) {
+        if (dirty_edicts[i] < game3_export->num_edicts)
+            sync_single_edict_game_to_server(dirty_edicts[i]);
+        Q_ClearBit(dirty_edicts_bits, dirty_edicts[i]);
+    }
+    num_dirty_edicts = 0;
+
+    for (i = old_num_edicts; i < game3_export->num_edicts; i++) {
+        sync_single_edict_game_to_server(i);
+    }
+
+    game_export.num_edicts = game3_export->num_edicts;
 }
 
 static void wrap_PreInit(void) { }
 
 static void wrap_Init(void)
 {
+    sv_game3_fullsync = Cvar_Get("sv_game3_fullsync", "0", 0);
+
     game3_export->Init();
 
     // Games with Q2PRO extensions use different limits/configstring IDs
@@ -766,24 +846,96 @@ static char* make_temp_directory(void)
 #endif
 }
 
-static char* read_as_base85(const char* filename, size_t* result_size)
+/* Game 3 interface only supports reading and writing files.
+ * Where possible, back those files by anonymous memory so that
+ * save data doesn't need a round trip through the temp directory. */
+typedef struct {
+    char    path[MAX_OSPATH];
+    char    *dir;   // temp directory, if not memory backed
+    int     fd;     // memfd, or -1
+} save_stream_t;
+
+static void open_save_stream(save_stream_t *s, const char *name)
+{
+    s->dir = NULL;
+    s->fd = -1;
+
+#if USE_MEMFD
+    s->fd = memfd_create(name, MFD_CLOEXEC);
+    if (s->fd != -1) {
+        // game opens the file by name, this needs procfs
+        Q_snprintf(s->path, sizeof(s->path), "/proc/self/fd/%d", s->fd);
+        if (os_access(s->path, R_OK | W_OK) == 0)
+            return;
+        close(s->fd);
+        s->fd = -1;
+    }
+#endif
+
+    s->dir = make_temp_directory();
+    if (!s->dir)
+        Com_Error(ERR_DROP, "Couldn't create temp dir for %s", name);
+    Q_snprintf(s->path, sizeof(s->path), "%s/%s", s->dir, name);
+}
+
+static void close_save_stream(save_stream_t *s)
+{
+#if USE_MEMFD
+    if (s->fd != -1) {
+        close(s->fd);
+        return;
+    }
+#endif
+    os_unlink(s->path);
+    os_rmdir(s->dir);
+    Z_Free(s->dir);
+}
+
+static void *read_save_stream(const save_stream_t *s, size_t *size)
 {
-    FILE *f = fopen(filename, "rb");
+    FILE *f = fopen(s->path, "rb");
     if (!f)
-        Com_Error(ERR_DROP, "Couldn't open %s", filename);
+        Com_Error(ERR_DROP, "Couldn't open %s", s->path);
 
-    struct base85_context_t ctx;
-    ascii85_context_init(&ctx);
+    Q_STATBUF st;
+    if (os_fstat(os_fileno(f), &st) || st.st_size < 0 || st.st_size > INT_MAX) {
+        fclose(f);
+        Com_Error(ERR_DROP, "Couldn't stat %s", s->path);
+    }
 
-    uint8_t buf[1024];
-    while(!feof(f)) {
-        size_t num_read = fread(buf, sizeof(char), sizeof(buf) / sizeof(buf[0]), f);
-        if (num_read == 0 && ferror(f))
-            Com_Error(ERR_DROP, "Error reading %s", filename);
-        ascii85_encode(buf, num_read, &ctx);
+    size_t len = st.st_size;
+    byte *data = Z_Malloc(len + 1);
+    if (fread(data, 1, len, f) != len) {
+        fclose(f);
+        Z_Free(data);
+        Com_Error(ERR_DROP, "Error reading %s", s->path);
     }
     fclose(f);
 
+    data[len] = 0;
+    *size = len;
+    return data;
+}
+
+static void write_save_stream(const save_stream_t *s, const void *data, size_t size)
+{
+    FILE *f = fopen(s->path, "wb");
+    if (!f)
+        Com_Error(ERR_DROP, "Couldn't open %s", s->path);
+
+    if (fwrite(data, 1, size, f) != size) {
+        fclose(f);
+        Com_Error(ERR_DROP, "Error writing %s", s->path);
+    }
+    fclose(f);
+}
+
+static char *encode_base85(const void *data, size_t size, size_t *result_size)
+{
+    struct base85_context_t ctx;
+    ascii85_context_init(&ctx);
+
+    ascii85_encode(data, size, &ctx);
     ascii85_encode_last(&ctx);
 
     const char *encoded_data = (const char *)ascii85_get_output(&ctx, result_size);
@@ -793,114 +945,146 @@ static char* read_as_base85(const char* filename, size_t* result_size)
     return result;
 }
 
-static void write_as_base85(const char* filename, const char* base85)
+static void write_base85_save_stream(const save_stream_t *s, const char *base85, size_t len)
 {
-    FILE *f = fopen(filename, "wb");
-    if (!f)
-        Com_Error(ERR_DROP, "Couldn't open %s", filename);
-
     struct base85_context_t ctx;
     ascii85_context_init(&ctx);
 
-    ascii85_decode((const uint8_t*)base85, strlen(base85), &ctx);
+    ascii85_decode((const uint8_t *)base85, len, &ctx);
     ascii85_decode_last(&ctx);
 
     size_t data_size = 0;
     const uint8_t *data = ascii85_get_output(&ctx, &data_size);
-    if (fwrite(data, 1, data_size, f) != data_size)
-        Com_Error(ERR_DROP, "Error writing %s", filename);
-    fclose(f);
+    write_save_stream(s, data, data_size);
 
     ascii85_context_destroy(&ctx);
 }
 
-static char* wrap_WriteGameJson(bool autosave, size_t* json_size)
+// savegames written before binary savegames extension are base85 encoded,
+// while game 3 binary savegames never consist of base85 alphabet only
+static bool is_base85(const byte *data, size_t size)
 {
+    for (size_t i = 0; i < size; i++)
+        if ((data[i] < '!' || data[i] > 'u') && data[i] != 'z')
+            return false;
+    return true;
+}
+
+static void *write_game_stream(bool autosave, size_t *size)
+{
+    save_stream_t s;
+
     sync_edicts_server_to_game();
 
-    /* Game 3 interface only supports writing to files.
-     * So have the game write itself to a temp file,
-     * and read _that_ file, and encode it into a string... */
-    char *save_dir = make_temp_directory();
-    if (!save_dir)
-        Com_Error(ERR_DROP, "Couldn't create temp dir to save game");
+    open_save_stream(&s, "game.ssv");
+    game3_export->WriteGame(s.path, autosave);
+    void *data = read_save_stream(&s, size);
+    close_save_stream(&s);
 
-    char game_fn[MAX_OSPATH];
-    Q_snprintf(game_fn, sizeof(game_fn), "%s/game.ssv", save_dir);
-    game3_export->WriteGame(game_fn, autosave);
+    return data;
+}
 
-    char* result = read_as_base85(game_fn, json_size);
+static void read_game_stream(const void *data, size_t size, bool base85)
+{
+    save_stream_t s;
 
-    os_unlink(game_fn);
-    os_rmdir(save_dir);
-    Z_Free(save_dir);
+    open_save_stream(&s, "game.ssv");
+    if (base85)
+        write_base85_save_stream(&s, data, size);
+    else
+        write_save_stream(&s, data, size);
+    game3_export->ReadGame(s.path);
+    close_save_stream(&s);
 
-    return result;
+    sync_edicts_game_to_server();
 }
 
-static void wrap_ReadGameJson(const char *json)
+static void *write_level_stream(size_t *size)
 {
-    /* Game 3 interface only supports reading files.
-     * So decode the game data into a temp file
-     * and read _that_ file... */
-    char *save_dir = make_temp_directory();
-    if (!save_dir)
-        Com_Error(ERR_DROP, "Couldn't create temp dir to load game");
+    save_stream_t s;
 
-    char game_fn[MAX_OSPATH];
-    Q_snprintf(game_fn, sizeof(game_fn), "%s/game.ssv", save_dir);
-    write_as_base85(game_fn, json);
+    sync_edicts_server_to_game();
 
-    game3_export->ReadGame(game_fn);
+    open_save_stream(&s, "level.sav");
+    game3_export->WriteLevel(s.path);
+    void *data = read_save_stream(&s, size);
+    close_save_stream(&s);
 
-    os_unlink(game_fn);
-    os_rmdir(save_dir);
-    Z_Free(save_dir);
+    return data;
+}
+
+static void read_level_stream(const void *data, size_t size, bool base85)
+{
+    save_stream_t s;
+
+    open_save_stream(&s, "level.sav");
+    if (base85)
+        write_base85_save_stream(&s, data, size);
+    else
+        write_save_stream(&s, data, size);
+    game3_export->ReadLevel(s.path);
+    close_save_stream(&s);
 
     sync_edicts_game_to_server();
 }
 
-static char* wrap_WriteLevelJson(bool transition, size_t* json_size)
+static void *wrap_WriteGame(bool autosave, size_t *size)
 {
-    sync_edicts_server_to_game();
+    return write_game_stream(autosave, size);
+}
 
-    /* Game 3 interface only supports writing to files.
-     * So have the game write itself to a temp file,
-     * and read _that_ file, and encode it into a string... */
-    char *save_dir = make_temp_directory();
-    if (!save_dir)
-        Com_Error(ERR_DROP, "Couldn't create temp dir to save level");
+static void wrap_ReadGame(const void *data, size_t size)
+{
+    read_game_stream(data, size, is_base85(data, size));
+}
+
+static void *wrap_WriteLevel(bool transition, size_t *size)
+{
+    return write_level_stream(size);
+}
 
-    char level_fn[MAX_OSPATH];
-    Q_snprintf(level_fn, sizeof(level_fn), "%s/level.sav", save_dir);
-    game3_export->WriteLevel(level_fn);
+static void wrap_ReadLevel(const void *data, size_t size)
+{
+    read_level_stream(data, size, is_base85(data, size));
+}
 
-    char* result = read_as_base85(level_fn, json_size);
+const char *game_q2pro_binary_savegames_ext = "q2pro:binary_savegames";
 
-    os_unlink(level_fn);
-    os_rmdir(save_dir);
-    Z_Free(save_dir);
+static const game_q2pro_binary_savegames_t game_q2pro_binary_savegames = {
+    .api_version = 1,
 
+    .WriteGame = wrap_WriteGame,
+    .ReadGame = wrap_ReadGame,
+    .WriteLevel = wrap_WriteLevel,
+    .ReadLevel = wrap_ReadLevel,
+};
+
+static char* wrap_WriteGameJson(bool autosave, size_t* json_size)
+{
+    size_t size;
+    void *data = write_game_stream(autosave, &size);
+    char *result = encode_base85(data, size, json_size);
+    Z_Free(data);
     return result;
 }
 
-static void wrap_ReadLevelJson(const char *json)
+static void wrap_ReadGameJson(const char *json)
 {
-    char *save_dir = make_temp_directory();
-    if (!save_dir)
-        Com_Error(ERR_DROP, "Couldn't create temp dir to load game");
-
-    char level_fn[MAX_OSPATH];
-    Q_snprintf(level_fn, sizeof(level_fn), "%s/level.sav", save_dir);
-    write_as_base85(level_fn, json);
-
-    game3_export->ReadLevel(level_fn);
+    read_game_stream(json, strlen(json), true);
+}
 
-    os_unlink(level_fn);
-    os_rmdir(save_dir);
-    Z_Free(save_dir);
+static char* wrap_WriteLevelJson(bool transition, size_t* json_size)
+{
+    size_t size;
+    void *data = write_level_stream(&size);
+    char *result = encode_base85(data, size, json_size);
+    Z_Free(data);
+    return result;
+}
 
-    sync_edicts_game_to_server();
+static void wrap_ReadLevelJson(const char *json)
+{
+    read_level_stream(json, strlen(json), true);
 }
 
 static bool wrap_CanSave(void)
@@ -974,27 +1158,33 @@ static void wrap_ClientDisconnect(edict_t *ent)
     game_export.num_edicts = game3_export->num_edicts;
 }
 
+/* ClientCommand() and ClientThink() may spawn new entities or change
+ * existing ones. Anything that matters to the server before the next frame
+ * (solidity, size, position) is changed along with linkentity(), so syncing
+ * edicts passed to imports is enough. Remaining changes are picked up by the
+ * full sync after RunFrame(). */
 static void wrap_ClientCommand(edict_t *ent)
 {
-    // ClientCommand() may spawn new entitities, so sync them all
-    sync_edicts_server_to_game();
+    int num_edicts = game_export.num_edicts;
+    sync_clients_server_to_game();
     game3_export->ClientCommand(translate_edict_to_game(ent));
-    sync_edicts_game_to_server();
+    sync_dirty_edicts_game_to_server(num_edicts);
 }
 
 static void wrap_ClientThink(edict_t *ent, usercmd_t *cmd)
 {
-    // ClientThink() may spawn new entitities, so sync them all
-    sync_edicts_server_to_game();
+    int num_edicts = game_export.num_edicts;
+    sync_clients_server_to_game();
     game3_usercmd_t game_cmd;
     ConvertToGame3_usercmd(&game_cmd, cmd);
     game3_export->ClientThink(translate_edict_to_game(ent), &game_cmd);
-    sync_edicts_game_to_server();
+    sync_dirty_edicts_game_to_server(num_edicts);
 }
 
 static void wrap_RunFrame(bool main_loop)
 {
-    sync_edicts_server_to_game();
+    // game may be ahead of server after ClientThink(), don't overwrite it
+    sync_clients_server_to_game();
     game3_export->RunFrame();
     sync_edicts_game_to_server();
 }
@@ -1030,6 +1220,9 @@ static void *wrap_GetExtension_export(const char *name)
         && strcmp(name, game_q2pro_customize_entity_ext) == 0) {
         return (void*)&game_q2pro_customize_entity;
     }
+    if (strcmp(name, game_q2pro_binary_savegames_ext) == 0) {
+        return (void*)&game_q2pro_binary_savegames;
+    }
     return NULL;
 }
 
@@ -24,6 +24,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 
 extern const char *game_q2pro_restart_filesystem_ext;
 extern const char *game_q2pro_customize_entity_ext;
+extern const char *game_q2pro_binary_savegames_ext;
 
 game_export_t *GetGame3Proxy(game_import_t *import, void *game3_entry, void *game3_ex_entry);
 
@@ -29,6 +29,12 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #define FOR_EACH_ACTIVE_GTV(client) \
     LIST_FOR_EACH(gtv_client_t, client, &gtv_active_list, active)
 
+#if USE_ZLIB
+#define GTV_SHARED(client)  (client)->shared
+#else
+#define GTV_SHARED(client)  false
+#endif
+
 typedef struct {
     list_t      entry;
     list_t      active;
@@ -36,6 +42,9 @@ typedef struct {
     netstream_t stream;
 #if USE_ZLIB
     z_stream    z;
+    bool        shared; // receives shared deflate stream
+    byte        pending[16];    // pong replies waiting for shared sync
+    unsigned    pendinglen;
 #endif
     unsigned    msglen;
     unsigned    lastmessage;
@@ -51,6 +60,24 @@ typedef struct {
     char        version[MAX_QPATH];
 } gtv_client_t;
 
+#if USE_ZLIB
+// deflate stream common to all GTV clients in shared mode. Frames are
+// compressed once and the output is copied into each client send buffer.
+// Per-client data can only be spliced in at full flush points. Pong
+// replies are held until the next regular sync, which is then upgraded
+// to a full flush, so that keepalives don't cost a full flush each.
+typedef struct {
+    z_stream    z;
+    uLong       adler;      // adler32 of data deflated since last flush
+    uLong       len;        // length of data deflated since last flush
+    bool        synced;     // nothing deflated since last full flush
+    bool        pending;    // some clients have private messages pending
+    unsigned    numclients;
+    unsigned    maxbuf;     // smallest maxbuf of shared clients
+    unsigned    bufcount;
+} gtv_shared_t;
+#endif
+
 typedef struct {
     bool            enabled;
     bool            active;
@@ -80,6 +107,10 @@ typedef struct {
     // TCP client pool
     int             maxclients;
     gtv_client_t    *clients; // [sv_mvd_maxclients]
+
+#if USE_ZLIB
+    gtv_shared_t    shared;
+#endif
 } mvd_server_t;
 
 static mvd_server_t     mvd;
@@ -109,6 +140,9 @@ static cvar_t   *sv_mvd_disconnect_time;
 static cvar_t   *sv_mvd_suspend_time;
 static cvar_t   *sv_mvd_allow_stufftext;
 static cvar_t   *sv_mvd_spawn_dummy;
+#if USE_ZLIB
+static cvar_t   *sv_mvd_shared_deflate;
+#endif
 
 static bool     mvd_enable(void);
 static void     mvd_disable(void);
@@ -116,8 +150,13 @@ static void     mvd_error(const char *reason);
 
 static void     write_stream(gtv_client_t *client, void *data, size_t len);
 static void     write_message(gtv_client_t *client, gtv_serverop_t op);
+static void     drop_client(gtv_client_t *client, const char *error);
 #if USE_ZLIB
 static void     flush_stream(gtv_client_t *client, int flush);
+static void     write_shared(const void *data, size_t len);
+static void     write_shared_message(gtv_serverop_t op);
+static void     sync_shared_stream(int flush);
+static void     end_shared_stream(void);
 #endif
 
 static void     rec_stop(void);
@@ -183,7 +222,7 @@ static void dummy_record_f(void)
         return;
     }
 
-    f = FS_EasyOpenFile(buffer, sizeof(buffer), FS_MODE_WRITE,
+    f = FS_EasyOpenFile(buffer, sizeof(buffer), FS_MODE_WRITE | FS_FLAG_ASYNC,
                         "demos/", Cmd_Argv(1), ".mvd2");
     if (!f) {
         return;
@@ -801,12 +840,19 @@ static void suspend_streams(void)
 {
     gtv_client_t *client;
 
+#if USE_ZLIB
+    write_shared_message(GTS_STREAM_DATA);
+    sync_shared_stream(Z_SYNC_FLUSH);
+#endif
+
     FOR_EACH_ACTIVE_GTV(client) {
         // send stream suspend marker
-        write_message(client, GTS_STREAM_DATA);
+        if (!GTV_SHARED(client)) {
+            write_message(client, GTS_STREAM_DATA);
 #if USE_ZLIB
-        flush_stream(client, Z_SYNC_FLUSH);
+            flush_stream(client, Z_SYNC_FLUSH);
 #endif
+        }
         NET_UpdateStream(&client->stream);
     }
 
@@ -829,12 +875,19 @@ static void resume_streams(void)
         return;
     }
 
+#if USE_ZLIB
+    write_shared_message(GTS_STREAM_DATA);
+    sync_shared_stream(Z_SYNC_FLUSH);
+#endif
+
     FOR_EACH_ACTIVE_GTV(client) {
         // send gamestate
-        write_message(client, GTS_STREAM_DATA);
+        if (!GTV_SHARED(client)) {
+            write_message(client, GTS_STREAM_DATA);
 #if USE_ZLIB
-        flush_stream(client, Z_SYNC_FLUSH);
+            flush_stream(client, Z_SYNC_FLUSH);
 #endif
+        }
         NET_UpdateStream(&client->stream);
     }
 
@@ -1053,7 +1106,23 @@ void SV_MvdEndFrame(void)
     header[2] = GTS_STREAM_DATA;
 
     // send frame to clients
+#if USE_ZLIB
+    if (mvd.shared.numclients) {
+        write_shared(header, sizeof(header));
+        write_shared(mvd.message.data, mvd.message.cursize);
+        write_shared(msg_write.data, msg_write.cursize);
+        write_shared(mvd.datagram.data, mvd.datagram.cursize);
+        if (++mvd.shared.bufcount > mvd.shared.maxbuf) {
+            sync_shared_stream(Z_SYNC_FLUSH);
+        }
+    }
+#endif
+
     FOR_EACH_ACTIVE_GTV(client) {
+        if (GTV_SHARED(client)) {
+            NET_UpdateStream(&client->stream);
+            continue;
+        }
         write_stream(client, header, sizeof(header));
         write_stream(client, mvd.message.data, mvd.message.cursize);
         write_stream(client, msg_write.data, msg_write.cursize);
@@ -1356,6 +1425,199 @@ static void flush_stream(gtv_client_t *client, int flush)
         }
     } while (ret == Z_OK);
 }
+
+// runs shared deflate stream and copies output to all shared clients
+static void deflate_shared(int flush)
+{
+    z_streamp z = &mvd.shared.z;
+    gtv_client_t *client;
+    byte buffer[MAX_GTS_MSGLEN];
+    size_t len;
+    int ret;
+
+    do {
+        z->next_out = buffer;
+        z->avail_out = sizeof(buffer);
+
+        ret = deflate(z, flush);
+
+        len = sizeof(buffer) - z->avail_out;
+        FOR_EACH_ACTIVE_GTV(client) {
+            if (!client->shared)
+                continue;
+            if (ret == Z_STREAM_ERROR) {
+                drop_client(client, "deflate() failed");
+                continue;
+            }
+            if (FIFO_Write(&client->stream.send, buffer, len) != len) {
+                drop_client(client, "overflowed");
+            }
+        }
+    } while (ret != Z_STREAM_ERROR && !z->avail_out);
+
+    // all shared clients are dropped, start over
+    if (ret == Z_STREAM_ERROR) {
+        end_shared_stream();
+    }
+}
+
+static void write_shared(const void *data, size_t len)
+{
+    gtv_shared_t *s = &mvd.shared;
+
+    if (!s->numclients || !len) {
+        return;
+    }
+
+    s->z.next_in = (Bytef *)data;
+    s->z.avail_in = (uInt)len;
+    s->adler = adler32(s->adler, data, len);
+    s->len += len;
+    s->synced = false;
+
+    deflate_shared(Z_NO_FLUSH);
+}
+
+static void write_shared_message(gtv_serverop_t op)
+{
+    byte header[3];
+
+    WL16(header, msg_write.cursize + 1);
+    header[2] = op;
+    write_shared(header, sizeof(header));
+
+    write_shared(msg_write.data, msg_write.cursize);
+}
+
+// inserts held private messages, shared stream must be fully flushed
+static void write_pending(gtv_client_t *client)
+{
+    if (!client->pendinglen) {
+        return;
+    }
+
+    write_stream(client, client->pending, client->pendinglen);
+    client->pendinglen = 0;
+    flush_stream(client, Z_FULL_FLUSH);
+}
+
+/*
+Flushes shared stream. After Z_FULL_FLUSH, no further shared output refers
+back to data before this point, so per-client data can be inserted into
+any shared client stream. Clients also join shared stream at such points.
+Z_SYNC_FLUSH is upgraded to full flush if private messages are pending.
+*/
+static void sync_shared_stream(int flush)
+{
+    gtv_shared_t *s = &mvd.shared;
+    gtv_client_t *client;
+
+    if (!s->numclients) {
+        return;
+    }
+
+    if (s->pending) {
+        flush = Z_FULL_FLUSH;
+    }
+
+    if (s->len || (flush == Z_FULL_FLUSH && !s->synced)) {
+        deflate_shared(flush);
+
+        // inflater on the other end checksums both private and shared data
+        FOR_EACH_ACTIVE_GTV(client) {
+            if (client->shared) {
+                client->z.adler = adler32_combine(client->z.adler, s->adler, s->len);
+            }
+        }
+
+        s->adler = adler32(0, NULL, 0);
+        s->len = 0;
+        s->synced = flush == Z_FULL_FLUSH;
+        s->bufcount = 0;
+    }
+
+    if (s->pending) {
+        FOR_EACH_ACTIVE_GTV(client) {
+            if (client->shared) {
+                write_pending(client);
+            }
+        }
+        s->pending = false;
+    }
+}
+
+static void update_shared_maxbuf(void)
+{
+    gtv_shared_t *s = &mvd.shared;
+    gtv_client_t *client;
+    bool first = true;
+
+    FOR_EACH_ACTIVE_GTV(client) {
+        if (client->shared && (first || s->maxbuf > client->maxbuf)) {
+            s->maxbuf = client->maxbuf;
+            first = false;
+        }
+    }
+}
+
+static bool join_shared_stream(gtv_client_t *client)
+{
+    gtv_shared_t *s = &mvd.shared;
+
+    if (!s->z.state) {
+        s->z.zalloc = SV_zalloc;
+        s->z.zfree = SV_zfree;
+        // raw deflate, zlib header is already sent on client stream
+        if (deflateInit2(&s->z, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+        s->adler = adler32(0, NULL, 0);
+        s->len = 0;
+        s->synced = true;
+    }
+
+    // make both streams independent of data sent before
+    sync_shared_stream(Z_FULL_FLUSH);
+    flush_stream(client, Z_FULL_FLUSH);
+
+    client->shared = true;
+    client->pendinglen = 0;
+    s->numclients++;
+    update_shared_maxbuf();
+    return true;
+}
+
+/*
+Client continues on its private stream, which has no history since it
+joined. Shared output only needs to end at byte boundary, unless private
+messages are pending.
+*/
+static void leave_shared_stream(gtv_client_t *client)
+{
+    if (!client->shared) {
+        return;
+    }
+
+    sync_shared_stream(Z_SYNC_FLUSH);
+
+    // dropped if deflate failed
+    if (!client->shared) {
+        return;
+    }
+
+    client->shared = false;
+    mvd.shared.numclients--;
+    update_shared_maxbuf();
+}
+
+static void end_shared_stream(void)
+{
+    if (mvd.shared.z.state) {
+        deflateEnd(&mvd.shared.z);
+    }
+    memset(&mvd.shared, 0, sizeof(mvd.shared));
+}
 #endif
 
 static void drop_client(gtv_client_t *client, const char *error)
@@ -1371,6 +1633,13 @@ static void drop_client(gtv_client_t *client, const char *error)
     }
 
 #if USE_ZLIB
+    if (client->shared) {
+        client->shared = false;
+        client->pendinglen = 0;
+        mvd.shared.numclients--;
+        update_shared_maxbuf();
+    }
+
     if (client->z.state) {
         // finish zlib stream
         flush_stream(client, Z_FINISH);
@@ -1437,9 +1706,35 @@ static void write_message(gtv_client_t *client, gtv_serverop_t op)
 
     WL16(header, msg_write.cursize + 1);
     header[2] = op;
+
+#if USE_ZLIB
+    // hold pong replies until shared stream is synced by next frames.
+    // no frames are sent while suspended, so don't wait then.
+    if (client->shared && mvd.active && op == GTS_PONG && client->pendinglen
+        + sizeof(header) + msg_write.cursize <= sizeof(client->pending)) {
+        memcpy(client->pending + client->pendinglen, header, sizeof(header));
+        client->pendinglen += sizeof(header);
+        memcpy(client->pending + client->pendinglen, msg_write.data, msg_write.cursize);
+        client->pendinglen += msg_write.cursize;
+        mvd.shared.pending = true;
+        return;
+    }
+
+    // private data can only be inserted at shared stream sync point
+    if (client->shared) {
+        sync_shared_stream(Z_FULL_FLUSH);
+    }
+#endif
+
     write_stream(client, header, sizeof(header));
 
     write_stream(client, msg_write.data, msg_write.cursize);
+
+#if USE_ZLIB
+    if (client->shared) {
+        flush_stream(client, Z_FULL_FLUSH);
+    }
+#endif
 }
 
 static bool auth_client(const gtv_client_t *client, const char *password)
@@ -1589,6 +1884,11 @@ static void parse_stream_start(gtv_client_t *client)
     }
 
 #if USE_ZLIB
+    // switch to shared stream
+    if (client->z.state && sv_mvd_shared_deflate->integer && join_shared_stream(client)) {
+        return;
+    }
+
     flush_stream(client, Z_SYNC_FLUSH);
 #endif
 }
@@ -1600,6 +1900,10 @@ static void parse_stream_stop(gtv_client_t *client)
         return;
     }
 
+#if USE_ZLIB
+    leave_shared_stream(client);
+#endif
+
     client->state = cs_primed;
 
     List_Delete(&client->active);
@@ -1958,6 +2262,10 @@ static void mvd_drop(gtv_serverop_t op)
 
     List_Init(&gtv_client_list);
     List_Init(&gtv_active_list);
+
+#if USE_ZLIB
+    end_shared_stream();
+#endif
 }
 
 // something bad happened, remove all clients
@@ -2026,8 +2334,12 @@ void SV_MvdMapChanged(void)
         }
 
         // send gamestate to all MVD clients
+#if USE_ZLIB
+        write_shared_message(GTS_STREAM_DATA);
+#endif
         FOR_EACH_ACTIVE_GTV(client) {
-            write_message(client, GTS_STREAM_DATA);
+            if (!GTV_SHARED(client))
+                write_message(client, GTS_STREAM_DATA);
             NET_UpdateStream(&client->stream);
         }
     }
@@ -2292,7 +2604,7 @@ void SV_MvdRecord_f(void)
 {
     char buffer[MAX_OSPATH];
     qhandle_t f;
-    unsigned mode = FS_MODE_WRITE;
+    unsigned mode = FS_MODE_WRITE | FS_FLAG_ASYNC;
     int c;
 
     if (sv.state != ss_game) {
@@ -2459,6 +2771,9 @@ void SV_MvdRegister(void)
     sv_mvd_suspend_time->changed(sv_mvd_suspend_time);
     sv_mvd_allow_stufftext = Cvar_Get("sv_mvd_allow_stufftext", "0", CVAR_LATCH);
     sv_mvd_spawn_dummy = Cvar_Get("sv_mvd_spawn_dummy", "1", 0);
+#if USE_ZLIB
+    sv_mvd_shared_deflate = Cvar_Get("sv_mvd_shared_deflate", "0", 0);
+#endif
 
     Cmd_Register(c_svmvd);
 }
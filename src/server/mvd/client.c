@@ -79,6 +79,7 @@ typedef struct gtv_s {
     int64_t         demosize, demoofs;
     float           demoprogress;
     bool            demowait;
+    demoindex_t     demoindex;
 } gtv_t;
 
 static const char *const gtv_states[GTV_NUM_STATES] = {
@@ -158,6 +159,8 @@ static void MVD_Free(mvd_t *mvd)
 
     CM_FreeMap(&mvd->cm);
 
+    MVD_FreeConfigstrings(mvd);
+
     Z_Free(mvd->delay.data);
 
     List_Remove(&mvd->entry);
@@ -180,6 +183,7 @@ static void MVD_Destroy(mvd_t *mvd)
 
     // destroy any existing GTV connection
     if (mvd->gtv) {
+        MVD_WriteDemoIndex(mvd);
         mvd->gtv->mvd = NULL; // don't double destroy
         mvd->gtv->destroy(mvd->gtv);
     }
@@ -548,7 +552,7 @@ static int demo_read_first(qhandle_t f)
 // state, configstrings and layouts at the given server frame.
 static void demo_emit_snapshot(mvd_t *mvd)
 {
-    mvd_snap_t *snap;
+    demosnap_t *snap;
     gtv_t *gtv;
     int64_t pos;
     char *from, *to;
@@ -580,9 +584,9 @@ static void demo_emit_snapshot(mvd_t *mvd)
     emit_base_frame(mvd);
 
     // write configstrings
-    for (i = 0; i < mvd->csr->end; i++) {
-        from = mvd->baseconfigstrings[i];
-        to = mvd->configstrings[i];
+    for (i = 0; mvd->privatecs && i < mvd->csr->end; i++) {
+        from = mvd->basecs->strings[i];
+        to = mvd->privatecs[i];
 
         if (!strcmp(from, to))
             continue;
@@ -655,7 +659,7 @@ static void demo_emit_snapshot(mvd_t *mvd)
     mvd->last_snapshot = mvd->framenum;
 }
 
-static mvd_snap_t *demo_find_snapshot(mvd_t *mvd, int64_t dest, bool byte_seek)
+static demosnap_t *demo_find_snapshot(mvd_t *mvd, int64_t dest, bool byte_seek)
 {
     int l = 0;
     int r = mvd->numsnapshots - 1;
@@ -665,7 +669,7 @@ static mvd_snap_t *demo_find_snapshot(mvd_t *mvd, int64_t dest, bool byte_seek)
 
     do {
         int m = (l + r) / 2;
-        mvd_snap_t *snap = mvd->snapshots[m];
+        demosnap_t *snap = mvd->snapshots[m];
         int64_t pos = byte_seek ? snap->filepos : snap->framenum;
         if (pos < dest)
             l = m + 1;
@@ -811,9 +815,35 @@ static void demo_play_next(gtv_t *gtv, string_entry_t *entry)
         gtv->demosize = gtv->demoofs = 0;
     }
 
+    // load snapshots saved by previous playback
+    Demo_InitIndex(&gtv->demoindex, entry->string, gtv->demoplayback, DEMO_INDEX_MVD2);
+    if (gtv->demosize && mvd_snaps->integer > 0) {
+        mvd_t *mvd = gtv->mvd;
+        int n = Demo_LoadIndex(&gtv->demoindex, &mvd->snapshots, TAG_MVD);
+        if (n) {
+            mvd->numsnapshots = n;
+            mvd->last_snapshot = mvd->snapshots[n - 1]->framenum;
+        }
+    }
+
     demo_emit_snapshot(gtv->mvd);
 }
 
+/*
+==============
+MVD_WriteDemoIndex
+
+Saves demo snapshots built so far. Called before snapshots are freed.
+==============
+*/
+void MVD_WriteDemoIndex(mvd_t *mvd)
+{
+    gtv_t *gtv = mvd->gtv;
+
+    if (gtv)
+        Demo_WriteIndex(&gtv->demoindex, mvd->snapshots, mvd->numsnapshots);
+}
+
 static void demo_free_playlist(gtv_t *gtv)
 {
     string_entry_t *entry, *next;
@@ -832,6 +862,7 @@ static void demo_destroy(gtv_t *gtv)
 
     // destroy any associated MVD channel
     if (mvd) {
+        MVD_WriteDemoIndex(mvd);
         mvd->gtv = NULL;
         MVD_Destroy(mvd);
     }
@@ -1934,7 +1965,7 @@ void MVD_StreamedRecord_f(void)
     mvd_t *mvd;
     uint32_t magic;
     uint16_t msglen;
-    unsigned mode = FS_MODE_WRITE;
+    unsigned mode = FS_MODE_WRITE | FS_FLAG_ASYNC;
     int ret;
     int c;
 
@@ -2240,10 +2271,10 @@ static void MVD_Seek_f(void)
     mvd_t *mvd;
     gtv_t *gtv;
     mvd_client_t *client;
-    mvd_snap_t *snap;
+    demosnap_t *snap;
     int i, j, ret, index, frames;
     int64_t dest;
-    char *from, *to;
+    char *to;
     edict_t *ent;
     bool gamestate, back_seek, byte_seek;
 
@@ -2343,16 +2374,7 @@ static void MVD_Seek_f(void)
             MVD_ClearState(mvd, false);
 
             // reset configstrings
-            for (i = 0; i < mvd->csr->end; i++) {
-                from = mvd->baseconfigstrings[i];
-                to = mvd->configstrings[i];
-
-                if (!strcmp(from, to))
-                    continue;
-
-                Q_SetBit(mvd->dcs, i);
-                strcpy(to, from);
-            }
+            MVD_ResetConfigstrings(mvd);
 
             // set player names
             MVD_SetPlayerNames(mvd);
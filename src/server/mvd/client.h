@@ -19,6 +19,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #pragma once
 
 #include "../server.h"
+#include "common/demoindex.h"
 #include <setjmp.h>
 
 #define MVD_Malloc(size)    Z_TagMalloc(size, TAG_MVD)
@@ -63,6 +64,15 @@ typedef struct mvd_cs_s {
     char string[1];
 } mvd_cs_t;
 
+// base configstrings are shared between channels playing the same map
+typedef struct {
+    list_t          entry;
+    int             refcount;
+    unsigned        hash;
+    const cs_remap_t *csr;
+    configstring_t  strings[1]; // [csr->end]
+} mvd_cstable_t;
+
 typedef struct {
     player_state_t ps;
     bool inuse;
@@ -116,13 +126,6 @@ typedef enum {
     MVD_NUM_STATES
 } mvd_state_t;
 
-typedef struct {
-    int framenum;
-    unsigned msglen;
-    int64_t filepos;
-    byte data[1];
-} mvd_snap_t;
-
 struct gtv_s;
 
 // FIXME: entire struct is > 500 kB in size!
@@ -142,7 +145,7 @@ typedef struct mvd_s {
     char        *demoname;
     bool        demoseeking;
     int         last_snapshot;
-    mvd_snap_t  **snapshots;
+    demosnap_t  **snapshots;
     int         numsnapshots;
 
     // delay buffer
@@ -164,8 +167,9 @@ typedef struct mvd_s {
     vec3_t          spawnAngles;
     int             pm_type;
     size_t          dcs[BC_COUNT(MAX_CONFIGSTRINGS)];
-    configstring_t  baseconfigstrings[MAX_CONFIGSTRINGS];
-    configstring_t  configstrings[MAX_CONFIGSTRINGS];
+    mvd_cstable_t   *basecs;        // shared, read only
+    configstring_t  *privatecs;     // allocated on first update
+    configstring_t  *configstrings; // points to either of the above
     const cs_remap_t *csr;
     msgEsFlags_t    esFlags;
     msgPsFlags_t    psFlags;
@@ -213,6 +217,7 @@ void MVD_File_g(genctx_t *ctx);
 void MVD_Spawn(void);
 
 void MVD_StopRecord(mvd_t *mvd);
+void MVD_WriteDemoIndex(mvd_t *mvd);
 
 void MVD_StreamedStop_f(void);
 void MVD_StreamedRecord_f(void);
@@ -227,6 +232,9 @@ int MVD_Frame(void);
 bool MVD_ParseMessage(mvd_t *mvd);
 void MVD_ParseEntityString(mvd_t *mvd, const char *data);
 void MVD_ClearState(mvd_t *mvd, bool full);
+configstring_t *MVD_WritableConfigstrings(mvd_t *mvd);
+void MVD_ResetConfigstrings(mvd_t *mvd);
+void MVD_FreeConfigstrings(mvd_t *mvd);
 
 //
 // mvd_game.c
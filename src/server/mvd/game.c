@@ -21,6 +21,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 //
 
 #include "client.h"
+#include "common/async.h"
 
 static cvar_t   *mvd_admin_password;
 static cvar_t   *mvd_part_filter;
@@ -40,6 +41,8 @@ mvd_player_t    mvd_dummy;
 
 static int      mvd_numplayers;
 
+static configstring_t   mvd_waitingConfigstrings[MAX_CONFIGSTRINGS_OLD];
+
 static void MVD_UpdateClient(mvd_client_t *client);
 
 /*
@@ -55,7 +58,7 @@ LAYOUTS
 
 #define VER_OFS (272 - (int)(sizeof(VERSION) - 1) * CONCHAR_WIDTH)
 
-static void MVD_LayoutClients(mvd_client_t *client)
+static int MVD_LayoutClients(mvd_client_t *client, sizebuf_t *buf)
 {
     static const char header[] =
         "xv 16 yv 0 string2 \"    Name            RTT Status\"";
@@ -124,12 +127,9 @@ static void MVD_LayoutClients(mvd_client_t *client)
         flags |= MSG_RELIABLE;
     }
 
-    // send the layout
-    MSG_WriteByte(svc_layout);
-    MSG_WriteData(layout, total + 1);
-    SV_ClientAddMessage(client->cl, flags);
-
-    client->layout_time = svs.realtime;
+    SZ_WriteByte(buf, svc_layout);
+    SZ_Write(buf, layout, total + 1);
+    return flags;
 }
 
 static int MVD_CountClients(mvd_t *mvd)
@@ -145,7 +145,7 @@ static int MVD_CountClients(mvd_t *mvd)
     return count;
 }
 
-static void MVD_LayoutChannels(mvd_client_t *client)
+static int MVD_LayoutChannels(mvd_client_t *client, sizebuf_t *buf)
 {
     static const char header[] =
         "xv 32 yv 8 picn inventory "
@@ -218,12 +218,9 @@ static void MVD_LayoutChannels(mvd_client_t *client)
 
     layout[total] = 0;
 
-    // send the layout
-    MSG_WriteByte(svc_layout);
-    MSG_WriteData(layout, total + 1);
-    SV_ClientAddMessage(client->cl, MSG_RELIABLE | MSG_CLEAR | MSG_COMPRESS_AUTO);
-
-    client->layout_time = svs.realtime;
+    SZ_WriteByte(buf, svc_layout);
+    SZ_Write(buf, layout, total + 1);
+    return MSG_RELIABLE | MSG_CLEAR | MSG_COMPRESS_AUTO;
 }
 
 #define MENU_ITEMS  10
@@ -241,7 +238,7 @@ static int clamp_menu_cursor(mvd_client_t *client)
     return client->layout_cursor;
 }
 
-static void MVD_LayoutMenu(mvd_client_t *client)
+static int MVD_LayoutMenu(mvd_client_t *client, sizebuf_t *buf)
 {
     static const char format[] =
         "xv 32 yv 8 picn inventory "
@@ -279,15 +276,12 @@ static void MVD_LayoutMenu(mvd_client_t *client)
                         "xv 0 yv 160 cstring [BUFFERING]" : "",
                         VER_OFS);
 
-    // send the layout
-    MSG_WriteByte(svc_layout);
-    MSG_WriteData(layout, total + 1);
-    SV_ClientAddMessage(client->cl, MSG_RELIABLE | MSG_CLEAR | MSG_COMPRESS_AUTO);
-
-    client->layout_time = svs.realtime;
+    SZ_WriteByte(buf, svc_layout);
+    SZ_Write(buf, layout, total + 1);
+    return MSG_RELIABLE | MSG_CLEAR | MSG_COMPRESS_AUTO;
 }
 
-static void MVD_LayoutScores(mvd_client_t *client)
+static int MVD_LayoutScores(mvd_client_t *client, sizebuf_t *buf)
 {
     mvd_t *mvd = client->mvd;
     int flags = MSG_CLEAR | MSG_COMPRESS_AUTO;
@@ -307,15 +301,12 @@ static void MVD_LayoutScores(mvd_client_t *client)
         flags |= MSG_RELIABLE;
     }
 
-    // send the layout
-    MSG_WriteByte(svc_layout);
-    MSG_WriteString(layout);
-    SV_ClientAddMessage(client->cl, flags);
-
-    client->layout_time = svs.realtime;
+    SZ_WriteByte(buf, svc_layout);
+    SZ_WriteString(buf, layout);
+    return flags;
 }
 
-static void MVD_LayoutFollow(mvd_client_t *client)
+static int MVD_LayoutFollow(mvd_client_t *client, sizebuf_t *buf)
 {
     mvd_t *mvd = client->mvd;
     const char *name = client->target ? client->target->name : "<no target>";
@@ -326,12 +317,9 @@ static void MVD_LayoutFollow(mvd_client_t *client)
                         "%s string \"[%s] Chasing %s\"",
                         mvd_chase_prefix->string, mvd->name, name);
 
-    // send the layout
-    MSG_WriteByte(svc_layout);
-    MSG_WriteData(layout, total + 1);
-    SV_ClientAddMessage(client->cl, MSG_RELIABLE | MSG_CLEAR);
-
-    client->layout_time = svs.realtime;
+    SZ_WriteByte(buf, svc_layout);
+    SZ_Write(buf, layout, total + 1);
+    return MSG_RELIABLE | MSG_CLEAR;
 }
 
 static void MVD_SetNewLayout(mvd_client_t *client, mvd_layout_t type)
@@ -378,48 +366,106 @@ static void MVD_SetFollowLayout(mvd_client_t *client)
     }
 }
 
+static bool MVD_LayoutExpired(mvd_client_t *client)
+{
+    mvd_t *mvd = client->mvd;
+
+    switch (client->layout_type) {
+    case LAYOUT_FOLLOW:
+        return !client->layout_time;
+    case LAYOUT_OLDSCORES:
+    case LAYOUT_SCORES:
+        return !client->layout_time || (!mvd->dummy && svs.realtime - client->layout_time > LAYOUT_MSEC);
+    case LAYOUT_MENU:
+        return mvd->dirty || !client->layout_time;
+    case LAYOUT_CLIENTS:
+        return svs.realtime - client->layout_time > LAYOUT_MSEC;
+    case LAYOUT_CHANNELS:
+        return mvd_dirty || !client->layout_time;
+    default:
+        return false;
+    }
+}
+
+// layout messages are built into private buffers, possibly on worker
+// threads, then added to clients on the main thread
+typedef struct {
+    mvd_client_t    *client;
+    sizebuf_t       buf;
+    int             flags;
+} layoutmsg_t;
+
+#define MAX_LAYOUTMSG   (MAX_NET_STRING + 1)
+
+static void build_layout_cb(void *arg, int index)
+{
+    layoutmsg_t *msg = (layoutmsg_t *)arg + index;
+    mvd_client_t *client = msg->client;
+
+    switch (client->layout_type) {
+    case LAYOUT_FOLLOW:
+        msg->flags = MVD_LayoutFollow(client, &msg->buf);
+        break;
+    case LAYOUT_OLDSCORES:
+    case LAYOUT_SCORES:
+        msg->flags = MVD_LayoutScores(client, &msg->buf);
+        break;
+    case LAYOUT_MENU:
+        msg->flags = MVD_LayoutMenu(client, &msg->buf);
+        break;
+    case LAYOUT_CLIENTS:
+        msg->flags = MVD_LayoutClients(client, &msg->buf);
+        break;
+    case LAYOUT_CHANNELS:
+        msg->flags = MVD_LayoutChannels(client, &msg->buf);
+        break;
+    default:
+        break;
+    }
+}
+
 // this is the only function that actually writes layouts
 static void MVD_UpdateLayouts(mvd_t *mvd)
 {
     mvd_client_t *client;
+    layoutmsg_t *msgs, *msg;
+    int i, count = 0;
+    size_t mark;
+
+    mark = Z_FrameMark();
+    msgs = Z_FrameAlloc(sizeof(msgs[0]) * List_Count(&mvd->clients));
 
     FOR_EACH_MVDCL(client, mvd) {
         if (client->cl->state != cs_spawned) {
             continue;
         }
         client->ps.stats[STAT_LAYOUTS] = client->layout_type ? 1 : 0;
-        switch (client->layout_type) {
-        case LAYOUT_FOLLOW:
-            if (!client->layout_time) {
-                MVD_LayoutFollow(client);
-            }
-            break;
-        case LAYOUT_OLDSCORES:
-        case LAYOUT_SCORES:
-            if (!client->layout_time || (!mvd->dummy && svs.realtime - client->layout_time > LAYOUT_MSEC)) {
-                MVD_LayoutScores(client);
-            }
-            break;
-        case LAYOUT_MENU:
-            if (mvd->dirty || !client->layout_time) {
-                MVD_LayoutMenu(client);
-            }
-            break;
-        case LAYOUT_CLIENTS:
-            if (svs.realtime - client->layout_time > LAYOUT_MSEC) {
-                MVD_LayoutClients(client);
-            }
-            break;
-        case LAYOUT_CHANNELS:
-            if (mvd_dirty || !client->layout_time) {
-                MVD_LayoutChannels(client);
-            }
-            break;
-        default:
-            break;
+        if (!MVD_LayoutExpired(client)) {
+            continue;
         }
+        msg = &msgs[count++];
+        msg->client = client;
+        msg->flags = 0;
+        SZ_InitWrite(&msg->buf, Z_FrameAlloc(MAX_LAYOUTMSG), MAX_LAYOUTMSG);
+    }
+
+    if (sv_parallel_frames->integer) {
+        Com_ParallelFor(count, build_layout_cb, msgs);
+    } else {
+        for (i = 0; i < count; i++)
+            build_layout_cb(msgs, i);
+    }
+
+    // send the layouts
+    for (i = 0; i < count; i++) {
+        msg = &msgs[i];
+        MSG_WriteData(msg->buf.data, msg->buf.cursize);
+        SV_ClientAddMessage(msg->client->cl, msg->flags);
+        msg->client->layout_time = svs.realtime;
     }
 
+    Z_FrameRelease(mark);
+
     mvd->dirty = false;
 }
 
@@ -646,7 +692,8 @@ static void MVD_UpdateTarget(mvd_client_t *client)
     }
 }
 
-static void MVD_UpdateClient(mvd_client_t *client)
+// only touches client's own state, so it can be called from worker threads
+static void MVD_UpdatePlayerState(mvd_client_t *client)
 {
     mvd_t *mvd = client->mvd;
     mvd_player_t *target = client->target;
@@ -695,18 +742,13 @@ static void MVD_UpdateClient(mvd_client_t *client)
         client->ps.pmove.pm_type = PM_FREEZE;
         client->clientNum = target - mvd->players;
 
-        if (target != mvd->dummy) {
-            if (mvd_stats_hack->integer && mvd->dummy) {
-                // copy stats of the dummy MVD observer
-                for (i = 0; i < MAX_STATS_OLD; i++) {
-                    if (mvd_stats_hack->integer & BIT(i)) {
-                        client->ps.stats[i] = mvd->dummy->ps.stats[i];
-                    }
+        if (target != mvd->dummy && mvd_stats_hack->integer && mvd->dummy) {
+            // copy stats of the dummy MVD observer
+            for (i = 0; i < MAX_STATS_OLD; i++) {
+                if (mvd_stats_hack->integer & BIT(i)) {
+                    client->ps.stats[i] = mvd->dummy->ps.stats[i];
                 }
             }
-
-            // chasing someone counts as activity
-            mvd_last_activity = svs.realtime;
         }
     }
 
@@ -721,6 +763,15 @@ static void MVD_UpdateClient(mvd_client_t *client)
     }
 }
 
+static void MVD_UpdateClient(mvd_client_t *client)
+{
+    MVD_UpdatePlayerState(client);
+
+    // chasing someone counts as activity
+    if (client->target && client->target != client->mvd->dummy)
+        mvd_last_activity = svs.realtime;
+}
+
 /*
 ==============================================================================
 
@@ -1803,6 +1854,7 @@ static void MVD_GameInit(void)
     Q_strlcpy(mvd->mapname, mvd_default_map->string, sizeof(mvd->mapname));
     List_Init(&mvd->clients);
 
+    mvd->configstrings = mvd_waitingConfigstrings;
     strcpy(mvd->configstrings[CS_NAME], "Waiting Room");
     strcpy(mvd->configstrings[CS_SKY], "unit1_");
     strcpy(mvd->configstrings[CS_MAXCLIENTS_OLD], "8");
@@ -2251,12 +2303,28 @@ static void MVD_NotifyClient(mvd_client_t *client)
     client->notified = true;
 }
 
-// called just after new frame is parsed
+static void update_client_cb(void *arg, int index)
+{
+    mvd_client_t **clients = arg;
+    MVD_UpdatePlayerState(clients[index]);
+}
+
+/*
+==================
+MVD_UpdateClients
+
+Called just after new frame is parsed. Follow targets are updated and
+notifications are sent serially, player states are copied in parallel
+if sv_parallel_frames is enabled.
+==================
+*/
 void MVD_UpdateClients(mvd_t *mvd)
 {
-    mvd_client_t *client;
+    mvd_client_t *client, **clients;
     bool intermission = mvd_freeze_hack->integer
         && mvd->dummy && mvd->dummy->ps.pmove.pm_type == PM_FREEZE;
+    int i, count = 0;
+    size_t mark;
 
     // check for intermission
     if (!mvd->intermission && intermission)
@@ -2264,14 +2332,35 @@ void MVD_UpdateClients(mvd_t *mvd)
     else if (mvd->intermission && !intermission)
         MVD_IntermissionStop(mvd);
 
+    mark = Z_FrameMark();
+    clients = Z_FrameAlloc(sizeof(clients[0]) * List_Count(&mvd->clients));
+
     // update UDP clients
     FOR_EACH_MVDCL(client, mvd) {
         if (client->cl->state == cs_spawned) {
             MVD_UpdateTarget(client);
-            MVD_UpdateClient(client);
-            MVD_NotifyClient(client);
+            clients[count++] = client;
         }
     }
+
+    if (sv_parallel_frames->integer) {
+        Com_ParallelFor(count, update_client_cb, clients);
+    } else {
+        for (i = 0; i < count; i++)
+            MVD_UpdatePlayerState(clients[i]);
+    }
+
+    for (i = 0; i < count; i++) {
+        client = clients[i];
+
+        // chasing someone counts as activity
+        if (client->target && client->target != mvd->dummy)
+            mvd_last_activity = svs.realtime;
+
+        MVD_NotifyClient(client);
+    }
+
+    Z_FrameRelease(mark);
 }
 
 static void MVD_WriteDemoMessage(mvd_t *mvd)
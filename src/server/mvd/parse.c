@@ -554,7 +554,7 @@ static void MVD_ParseConfigstring(mvd_t *mvd)
         MVD_Destroyf(mvd, "%s: bad index: %d", __func__, index);
     }
 
-    s = mvd->configstrings[index];
+    s = MVD_WritableConfigstrings(mvd)[index];
     maxlen = Com_ConfigstringSize(mvd->csr, index);
     if (MSG_ReadString(s, maxlen) >= maxlen) {
         MVD_Destroyf(mvd, "%s: index %d overflowed", __func__, index);
@@ -787,6 +787,129 @@ static void MVD_ParseFrame(mvd_t *mvd)
     mvd->framenum++;
 }
 
+/*
+==============================================================================
+
+CONFIGSTRING TABLES
+
+Relays often carry several channels playing the same map. Base configstrings
+received with gamestate are kept in refcounted tables shared between such
+channels. Channel makes a private copy on first configstring update.
+
+==============================================================================
+*/
+
+static LIST_DECL(mvd_cstables);
+
+static unsigned hash_configstrings(const configstring_t *cs, int count)
+{
+    const byte *p = (const byte *)cs;
+    size_t i, len = sizeof(cs[0]) * count;
+    unsigned hash = 0;
+
+    for (i = 0; i < len; i++)
+        hash = hash * 31 + p[i];
+
+    return hash;
+}
+
+static void set_configstrings(mvd_t *mvd, configstring_t *cs)
+{
+    mvd_client_t *client;
+
+    mvd->configstrings = cs;
+
+    // clients reference channel configstrings directly
+    FOR_EACH_MVDCL(client, mvd)
+        client->cl->configstrings = cs;
+}
+
+static void release_base(mvd_t *mvd)
+{
+    mvd_cstable_t *table = mvd->basecs;
+
+    if (!table)
+        return;
+
+    Q_assert(table->refcount > 0);
+    if (--table->refcount == 0) {
+        List_Remove(&table->entry);
+        Z_Free(table);
+    }
+
+    mvd->basecs = NULL;
+}
+
+// replaces private configstrings with matching shared table
+static void share_configstrings(mvd_t *mvd)
+{
+    const configstring_t *cs = mvd->privatecs;
+    int count = mvd->csr->end;
+    size_t size = sizeof(cs[0]) * count;
+    unsigned hash = hash_configstrings(cs, count);
+    mvd_cstable_t *table;
+
+    release_base(mvd);
+
+    LIST_FOR_EACH(mvd_cstable_t, table, &mvd_cstables, entry) {
+        if (table->csr == mvd->csr && table->hash == hash &&
+            !memcmp(table->strings, cs, size)) {
+            Com_DPrintf("[%s] sharing base configstrings\n", mvd->name);
+            table->refcount++;
+            goto done;
+        }
+    }
+
+    table = MVD_Malloc(sizeof(*table) - sizeof(table->strings) + size);
+    table->refcount = 1;
+    table->hash = hash;
+    table->csr = mvd->csr;
+    memcpy(table->strings, cs, size);
+    List_Append(&mvd_cstables, &table->entry);
+
+done:
+    mvd->basecs = table;
+    set_configstrings(mvd, table->strings);
+    Z_Freep(&mvd->privatecs);
+}
+
+configstring_t *MVD_WritableConfigstrings(mvd_t *mvd)
+{
+    if (!mvd->privatecs) {
+        mvd->privatecs = MVD_Mallocz(sizeof(mvd->privatecs[0]) * MAX_CONFIGSTRINGS);
+        if (mvd->basecs)
+            memcpy(mvd->privatecs, mvd->basecs->strings,
+                   sizeof(mvd->privatecs[0]) * mvd->basecs->csr->end);
+        set_configstrings(mvd, mvd->privatecs);
+    }
+
+    return mvd->privatecs;
+}
+
+// reverts to base configstrings, marking changed ones dirty
+void MVD_ResetConfigstrings(mvd_t *mvd)
+{
+    int i;
+
+    if (!mvd->privatecs || !mvd->basecs)
+        return;
+
+    for (i = 0; i < mvd->csr->end; i++) {
+        if (strcmp(mvd->basecs->strings[i], mvd->privatecs[i]))
+            Q_SetBit(mvd->dcs, i);
+    }
+
+    set_configstrings(mvd, mvd->basecs->strings);
+    Z_Freep(&mvd->privatecs);
+}
+
+void MVD_FreeConfigstrings(mvd_t *mvd)
+{
+    release_base(mvd);
+    Z_Freep(&mvd->privatecs);
+    mvd->configstrings = NULL;
+}
+
 void MVD_ClearState(mvd_t *mvd, bool full)
 {
     mvd_player_t *player;
@@ -810,6 +933,7 @@ void MVD_ClearState(mvd_t *mvd, bool full)
         return;
 
     // free all snapshots
+    MVD_WriteDemoIndex(mvd);
     for (i = 0; i < mvd->numsnapshots; i++) {
         Z_Free(mvd->snapshots[i]);
     }
@@ -817,9 +941,8 @@ void MVD_ClearState(mvd_t *mvd, bool full)
 
     Z_Freep(&mvd->snapshots);
 
-    // free current map
-    CM_FreeMap(&mvd->cm);
-
+    // current map is kept until the new one is loaded, so that it doesn't
+    // need to be reloaded if unchanged
     VectorClear(mvd->spawnOrigin);
     VectorClear(mvd->spawnAngles);
 
@@ -828,7 +951,9 @@ void MVD_ClearState(mvd_t *mvd, bool full)
         //Q_strlcpy(mvd->oldscores, mvd->layout, sizeof(mvd->oldscores));
     }
 
-    memset(mvd->configstrings, 0, sizeof(mvd->configstrings[0]) * mvd->csr->end);
+    // start with empty private configstrings
+    release_base(mvd);
+    memset(MVD_WritableConfigstrings(mvd), 0, sizeof(mvd->privatecs[0]) * MAX_CONFIGSTRINGS);
     mvd->layout[0] = 0;
 
     mvd->framenum = 0;
@@ -878,6 +1003,7 @@ static void MVD_ParseServerData(mvd_t *mvd, int extrabits)
     int index;
     int ret;
     edict_t *ent;
+    cm_t oldcm;
 
     // clear the leftover from previous level
     MVD_ClearState(mvd, true);
@@ -1014,7 +1140,10 @@ static void MVD_ParseServerData(mvd_t *mvd, int extrabits)
 
     // load the world model (we are only interesed in visibility info)
     Com_Printf("[%s] -=- Loading %s...\n", mvd->name, string);
+    oldcm = mvd->cm;
+    memset(&mvd->cm, 0, sizeof(mvd->cm));
     ret = CM_LoadMap(&mvd->cm, string);
+    CM_FreeMap(&oldcm);
     if (ret) {
         Com_EPrintf("[%s] =!= Couldn't load %s: %s\n", mvd->name, string, BSP_ErrorString(ret));
         // continue with null visibility
@@ -1040,7 +1169,7 @@ static void MVD_ParseServerData(mvd_t *mvd, int extrabits)
     MVD_ParseFrame(mvd);
 
     // save base configstrings
-    memcpy(mvd->baseconfigstrings, mvd->configstrings, sizeof(mvd->baseconfigstrings[0]) * mvd->csr->end);
+    share_configstrings(mvd);
 
     // force initial snapshot
     mvd->last_snapshot = INT_MIN;
@@ -61,6 +61,16 @@ static struct {
 
     bool              setup_entities;
     int32_t           nav_frame;
+
+    // search statistics, only gathered while nav_bench runs
+    struct {
+        bool        enabled;
+        uint64_t    expanded;
+        uint64_t    traces;
+        uint64_t    contents;
+        uint32_t    open_size;
+        uint32_t    open_peak;
+    } stats;
 } nav_data;
 
 // invalid value used for most of the system
@@ -570,6 +580,8 @@ static nav_node_t *Nav_ClosestNodeTo(const vec3_t p, const PathRequest *request)
         // check visibility
         vec3_t end = { 0.f, 0.f, 32.f };
         VectorAdd(end, node->origin, end);
+        if (nav_data.stats.enabled)
+            nav_data.stats.traces++;
         trace_t tr = SV_Trace(p, vec3_origin, vec3_origin, end, NULL, MASK_SOLID | CONTENTS_PLAYERCLIP | CONTENTS_MONSTERCLIP);
 
         if (tr.fraction < 1.0f)
@@ -621,6 +633,9 @@ static inline void Nav_PushOpenSet(nav_ctx_t *ctx, const nav_node_t *node, float
     o->node = node;
     o->f_score = f;
 
+    if (nav_data.stats.enabled && ++nav_data.stats.open_size > nav_data.stats.open_peak)
+        nav_data.stats.open_peak = nav_data.stats.open_size;
+
     nav_open_t *open_where = LIST_FIRST(nav_open_t, &ctx->open_set_open, entry);
 
     while (!LIST_TERM(open_where, &ctx->open_set_open, entry)) {
@@ -779,6 +794,8 @@ static PathInfo Nav_Path_(nav_path_t *path)
     }
 
     if (!path->request->nodeSearch.ignoreNodeFlags) {
+        if (nav_data.stats.enabled)
+            nav_data.stats.contents += 2;
         if (SV_PointContents(path->request->start) & MASK_SOLID) {
             info.returnCode = PathReturnCode_InvalidStart;
             return info;
@@ -806,6 +823,8 @@ static PathInfo Nav_Path_(nav_path_t *path)
 
     for (int i = 0; i < nav_data.num_nodes; i++)
         List_Append(&ctx->open_set_free, &ctx->open_set[i].entry);
+
+    nav_data.stats.open_size = 0;
     
     ctx->came_from[start_id] = -1;
     ctx->g_score[start_id] = 0;
@@ -824,6 +843,10 @@ static PathInfo Nav_Path_(nav_path_t *path)
         // shift off the head, insert into free
         List_Remove(&cursor->entry);
         List_Insert(&ctx->open_set_free, &cursor->entry);
+        if (nav_data.stats.enabled) {
+            nav_data.stats.open_size--;
+            nav_data.stats.expanded++;
+        }
         
         int16_t current = cursor->node->id;
 
@@ -1465,12 +1488,302 @@ void Nav_Frame(void)
 #endif
 }
 
+/*
+===============================================================================
+
+BENCHMARK
+
+===============================================================================
+*/
+
+#define NAV_BENCH_POINTS    64
+#define NAV_BENCH_MAX       65536
+
+typedef struct {
+    PathFlags   flags;
+    bool        raw;
+    uint32_t    found;
+    uint32_t    nopath;
+    uint32_t    other;
+    uint64_t    expanded;
+    uint64_t    traces;
+    uint64_t    contents;
+    uint32_t    open_peak;
+    uint64_t    usec;
+    uint32_t    *latency;
+} nav_bench_t;
+
+static uint32_t Nav_BenchRand(uint32_t *state)
+{
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static bool Nav_BenchNodeUsable(const nav_node_t *node)
+{
+    return !(node->flags & (NodeFlag_Disabled | NodeFlag_NoPOI));
+}
+
+// flood fill from start using the same rules as a raw search;
+// returns number of nodes written to queue, start included
+static int Nav_BenchReachable(const nav_node_t *start, int16_t *queue, byte *visited)
+{
+    int head = 0, tail = 0;
+
+    memset(visited, 0, nav_data.node_link_bitmap_size);
+    Q_SetBit(visited, start->id);
+    queue[tail++] = start->id;
+
+    while (head < tail) {
+        const nav_node_t *node = &nav_data.nodes[queue[head++]];
+
+        for (const nav_link_t *link = node->links; link != node->links + node->num_links; link++) {
+            if (Q_IsBitSet(visited, link->target->id))
+                continue;
+            if (!Nav_BenchNodeUsable(link->target))
+                continue;
+            Q_SetBit(visited, link->target->id);
+            queue[tail++] = link->target->id;
+        }
+    }
+
+    return tail;
+}
+
+static const char *Nav_BenchFlagsString(const nav_bench_t *b)
+{
+    static char buffer[8];
+
+    if (b->raw)
+        return "raw";
+
+    buffer[0] = (b->flags & PathFlags_Water) ? 'S' : '-';
+    buffer[1] = (b->flags & PathFlags_Walk) ? 'W' : '-';
+    buffer[2] = (b->flags & PathFlags_WalkOffLedge) ? 'L' : '-';
+    buffer[3] = (b->flags & PathFlags_LongJump) ? 'J' : '-';
+    buffer[4] = (b->flags & PathFlags_BarrierJump) ? 'B' : '-';
+    buffer[5] = (b->flags & PathFlags_Elevator) ? 'E' : '-';
+    buffer[6] = 0;
+
+    return buffer;
+}
+
+static int uint32cmp(const void *p1, const void *p2)
+{
+    uint32_t a = *(const uint32_t *)p1;
+    uint32_t b = *(const uint32_t *)p2;
+    return a < b ? -1 : a > b;
+}
+
+static const cmd_option_t o_nav_bench[] = {
+    { "f", "fatal", "exit with error if validation fails" },
+    { "h", "help", "display this message" },
+    { NULL }
+};
+
+/*
+==============
+Nav_Bench_f
+
+Runs random reachable node pairs through the path finder with every
+meaningful combination of path flags and reports search statistics.
+With -f, validation failures are fatal, so that a dedicated server
+started with `+map <name> +nav_bench -f <count> +quit' can be used
+as a headless regression test.
+==============
+*/
+static void Nav_Bench_f(void)
+{
+    nav_bench_t benches[64], *b;
+    vec3_t points[NAV_BENCH_POINTS];
+    int num_benches = 0, num_pairs = 0, failures = 0;
+    int16_t *pairs = NULL, *queue = NULL;
+    uint32_t *latency = NULL;
+    byte *visited = NULL;
+    bool fatal = false;
+    uint32_t state, seed;
+    int i, c, count;
+
+    while ((c = Cmd_ParseOptions(o_nav_bench)) != -1) {
+        switch (c) {
+        case 'h':
+            Cmd_PrintUsage(o_nav_bench, "<count> [seed]");
+            Com_Printf("Benchmark and validate the navigation graph.\n");
+            Cmd_PrintHelp(o_nav_bench);
+            return;
+        case 'f':
+            fatal = true;
+            break;
+        default:
+            return;
+        }
+    }
+
+    if (!cmd_optarg[0]) {
+        Com_Printf("Missing count argument.\n");
+        Cmd_PrintHint();
+        return;
+    }
+
+    if (!nav_data.num_nodes || !nav_data.ctx) {
+        if (fatal)
+            Com_Error(ERR_FATAL, "%s: no navigation data loaded", Cmd_Argv(0));
+        Com_Printf("No navigation data loaded.\n");
+        return;
+    }
+
+    count = Q_clip(Q_atoi(cmd_optarg), 1, NAV_BENCH_MAX);
+    if (cmd_optind + 1 < Cmd_Argc())
+        seed = strtoul(Cmd_Argv(cmd_optind + 1), NULL, 10);
+    else
+        seed = Sys_Milliseconds();
+    state = seed ? seed : 1;
+
+    // every combination that includes walking or swimming,
+    // plus unconditional search that ignores node flags
+    for (i = 0; i < 64; i++) {
+        if (!(i & (PathFlags_Walk | PathFlags_Water)))
+            continue;
+        b = &benches[num_benches++];
+        memset(b, 0, sizeof(*b));
+        b->flags = i;
+    }
+    b = &benches[num_benches++];
+    memset(b, 0, sizeof(*b));
+    b->flags = PathFlags_Walk;
+    b->raw = true;
+
+    pairs = Z_Malloc(sizeof(pairs[0]) * count * 2);
+    queue = Z_Malloc(sizeof(queue[0]) * nav_data.num_nodes);
+    visited = Z_Malloc(nav_data.node_link_bitmap_size);
+    latency = Z_Malloc(sizeof(latency[0]) * count * num_benches);
+
+    // sample node pairs with goal reachable from start
+    for (i = 0; i < count * 8 && num_pairs < count; i++) {
+        const nav_node_t *start = &nav_data.nodes[Nav_BenchRand(&state) % nav_data.num_nodes];
+
+        if (!Nav_BenchNodeUsable(start))
+            continue;
+
+        int reached = Nav_BenchReachable(start, queue, visited);
+        if (reached < 2)
+            continue;
+
+        pairs[num_pairs * 2 + 0] = start->id;
+        pairs[num_pairs * 2 + 1] = queue[1 + Nav_BenchRand(&state) % (reached - 1)];
+        num_pairs++;
+    }
+
+    if (!num_pairs) {
+        Com_Printf("No reachable node pairs found.\n");
+        failures++;
+        goto done;
+    }
+
+    for (b = benches; b < benches + num_benches; b++) {
+        b->latency = latency + (b - benches) * num_pairs;
+
+        for (i = 0; i < num_pairs; i++) {
+            const nav_node_t *start = &nav_data.nodes[pairs[i * 2 + 0]];
+            const nav_node_t *goal = &nav_data.nodes[pairs[i * 2 + 1]];
+            PathRequest request = { 0 };
+            nav_path_t path = { .request = &request };
+
+            VectorCopy(start->origin, request.start);
+            VectorCopy(goal->origin, request.goal);
+            request.pathFlags = b->flags;
+            request.nodeSearch.ignoreNodeFlags = b->raw;
+            request.pathPoints.posArray = points;
+            request.pathPoints.count = NAV_BENCH_POINTS;
+
+            nav_data.stats.expanded = 0;
+            nav_data.stats.traces = 0;
+            nav_data.stats.contents = 0;
+            nav_data.stats.open_peak = 0;
+            nav_data.stats.enabled = true;
+
+            uint64_t usec = Sys_Microseconds();
+            PathInfo info = Nav_Path_(&path);
+            usec = Sys_Microseconds() - usec;
+
+            nav_data.stats.enabled = false;
+
+            b->latency[i] = min(usec, UINT32_MAX);
+            b->usec += usec;
+            b->expanded += nav_data.stats.expanded;
+            b->traces += nav_data.stats.traces;
+            b->contents += nav_data.stats.contents;
+            b->open_peak = max(b->open_peak, nav_data.stats.open_peak);
+
+            switch (info.returnCode) {
+            case PathReturnCode_InProgress:
+            case PathReturnCode_TraversalPending:
+            case PathReturnCode_RawPathFound:
+            case PathReturnCode_ReachedGoal:
+                b->found++;
+                break;
+            case PathReturnCode_NoPathFound:
+                b->nopath++;
+                // flood fill proved goal is reachable without flag
+                // checks, so raw search must never fail here
+                if (b->raw && path.start == start && path.goal == goal) {
+                    Com_WPrintf("%s: no raw path from node %d to %d\n",
+                                Cmd_Argv(0), start->id, goal->id);
+                    failures++;
+                }
+                break;
+            default:
+                b->other++;
+                break;
+            }
+        }
+    }
+
+    Com_Printf("%d pairs, seed %u, %d nodes, %d links\n",
+               num_pairs, seed, nav_data.num_nodes, nav_data.num_links);
+    Com_Printf("flags: S=water W=walk L=ledge J=longjump B=barrier E=elevator\n");
+    Com_Printf("flags  found nopath other   q/sec  expand openpk traces points   p50   p90   p99   max\n"
+               "------ ----- ------ ----- ------- ------- ------ ------ ------ ----- ----- ----- -----\n");
+
+    for (b = benches; b < benches + num_benches; b++) {
+        qsort(b->latency, num_pairs, sizeof(b->latency[0]), uint32cmp);
+
+        Com_Printf("%-6s %5u %6u %5u %7.0f %7.1f %6u %6.1f %6.1f %5u %5u %5u %5u\n",
+                   Nav_BenchFlagsString(b), b->found, b->nopath, b->other,
+                   num_pairs * 1e6 / max(b->usec, 1),
+                   (double)b->expanded / num_pairs, b->open_peak,
+                   (double)b->traces / num_pairs,
+                   (double)b->contents / num_pairs,
+                   b->latency[num_pairs * 50 / 100],
+                   b->latency[num_pairs * 90 / 100],
+                   b->latency[num_pairs * 99 / 100],
+                   b->latency[num_pairs - 1]);
+    }
+
+    Com_Printf("Latencies are in microseconds, points are point contents queries. "
+               "%d validation failures.\n", failures);
+
+done:
+    Z_Free(pairs);
+    Z_Free(queue);
+    Z_Free(visited);
+    Z_Free(latency);
+
+    if (fatal && failures)
+        Com_Error(ERR_FATAL, "%s: %d validation failures", Cmd_Argv(0), failures);
+}
+
 void Nav_Init(void)
 {
 #if USE_REF
     nav_debug = Cvar_Get("nav_debug", "0", 0);
     nav_debug_range = Cvar_Get("nav_debug_range", "512", 0);
 #endif
+
+    Cmd_AddCommand("nav_bench", Nav_Bench_f);
 }
 
 void Nav_Shutdown(void)
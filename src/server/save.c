@@ -17,6 +17,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 */
 
 #include "server.h"
+#include "common/async.h"
 #include "common/mapdb.h"
 
 #define SAVE_MAGIC1     MakeLittleLong('S','S','V','2')
@@ -45,6 +46,209 @@ static cvar_t   *sv_noreload;
 
 static bool have_enhanced_savegames(void);
 
+/*
+==============================================================================
+
+ASYNC WRITES
+
+Game state blobs are snapshotted on the main thread, then compressed and
+written out by a worker, so that autosaves don't stall level transitions.
+Anything that reads or touches save directories must wait for pending
+writes with flush_save_files() first.
+
+==============================================================================
+*/
+
+// compressed blobs are wrapped into a header of engine's own, game never
+// sees it. blobs without it are stored as is.
+#define SAVE_BLOB_MAGIC     MakeLittleLong('S','V','Z','1')
+
+typedef struct {
+    uint32_t    magic;
+    uint32_t    size;
+    uint32_t    csize;
+} saveblob_t;
+
+typedef struct {
+    char        path[MAX_OSPATH];
+    byte        *data;      // snapshot, owned by job
+    size_t      size;
+    byte        *out;       // allocated on main thread, zone isn't thread safe
+    size_t      outsize;
+    int         status;
+} savework_t;
+
+static int      save_pending;
+static bool     save_failed;
+
+static void save_work_cb(void *arg)
+{
+    savework_t *w = arg;
+    const byte *data = w->data;
+    size_t size = w->size;
+    FILE *fp;
+
+#if USE_ZLIB
+    saveblob_t *blob = (saveblob_t *)w->out;
+    uLongf csize = w->outsize - sizeof(*blob);
+
+    if (compress2(w->out + sizeof(*blob), &csize, w->data, w->size, Z_DEFAULT_COMPRESSION) == Z_OK) {
+        blob->magic = LittleLong(SAVE_BLOB_MAGIC);
+        blob->size = LittleLong(w->size);
+        blob->csize = LittleLong(csize);
+        data = w->out;
+        size = sizeof(*blob) + csize;
+    }
+#endif
+
+    fp = fopen(w->path, "wb");
+    if (!fp) {
+        w->status = Q_ERRNO;
+        return;
+    }
+
+    if (fwrite(data, 1, size, fp) != size)
+        w->status = Q_ERRNO;
+
+    if (fclose(fp) && !w->status)
+        w->status = Q_ERRNO;
+}
+
+static void save_done_cb(void *arg)
+{
+    savework_t *w = arg;
+
+    if (w->status < 0) {
+        Com_EPrintf("Couldn't write %s: %s\n", w->path, Q_ErrorString(w->status));
+        remove(w->path);
+        save_failed = true;
+    }
+
+    Z_Free(w->data);
+    Z_Free(w->out);
+    Z_Free(w);
+    save_pending--;
+}
+
+/*
+==============
+queue_save_file
+
+Takes ownership of data, which must be allocated with Z_Malloc.
+==============
+*/
+static int queue_save_file(const char *name, void *data, size_t size)
+{
+    savework_t *w;
+    char path[MAX_OSPATH];
+
+    if (Q_snprintf(path, MAX_OSPATH, "%s/%s", fs_gamedir, name) >= MAX_OSPATH || FS_CreatePath(path)) {
+        Z_Free(data);
+        return -1;
+    }
+
+    w = Z_Mallocz(sizeof(*w));
+    Q_strlcpy(w->path, path, sizeof(w->path));
+    w->data = data;
+    w->size = size;
+#if USE_ZLIB
+    w->outsize = sizeof(saveblob_t) + compressBound(size);
+    w->out = Z_Malloc(w->outsize);
+#endif
+
+    save_pending++;
+
+    asyncwork_t work = {
+        .work_cb = save_work_cb,
+        .done_cb = save_done_cb,
+        .cb_arg = w,
+    };
+    Com_QueueAsyncWork(&work);
+    return 0;
+}
+
+/*
+==============
+flush_save_files
+
+Waits for all pending writes. Returns -1 if any of them failed.
+==============
+*/
+static int flush_save_files(void)
+{
+    int ret;
+
+    while (1) {
+        Com_CompleteAsyncWork();
+        if (!save_pending)
+            break;
+        Sys_Sleep(1);
+    }
+
+    ret = save_failed ? -1 : 0;
+    save_failed = false;
+    return ret;
+}
+
+/*
+==============
+load_save_file
+
+Waits for pending writes, then loads game state blob, unwrapping it if
+needed. Result is NUL terminated.
+==============
+*/
+static int load_save_file(const char *name, void **data)
+{
+    saveblob_t blob;
+    byte *buf, *out;
+    int len;
+
+    flush_save_files();
+
+    len = FS_LoadFile(name, (void **)&buf);
+    if (!buf)
+        return len;
+
+    if (len < sizeof(blob))
+        goto done;
+
+    memcpy(&blob, buf, sizeof(blob));
+    if (LittleLong(blob.magic) != SAVE_BLOB_MAGIC)
+        goto done;
+
+    blob.size = LittleLong(blob.size);
+    blob.csize = LittleLong(blob.csize);
+    if (blob.csize != len - sizeof(blob) || blob.size > MAX_LOADFILE) {
+        FS_FreeFile(buf);
+        Com_Error(ERR_DROP, "%s is truncated", name);
+    }
+
+#if USE_ZLIB
+    uLongf size = blob.size;
+
+    out = Z_Malloc(blob.size + 1);
+    if (uncompress(out, &size, buf + sizeof(blob), blob.csize) != Z_OK || size != blob.size) {
+        Z_Free(out);
+        FS_FreeFile(buf);
+        Com_Error(ERR_DROP, "Couldn't decompress %s", name);
+    }
+    out[size] = 0;
+
+    FS_FreeFile(buf);
+    buf = out;
+    len = size;
+#else
+    (void)out;
+    FS_FreeFile(buf);
+    Com_Error(ERR_DROP, "%s is compressed, but no zlib support linked in", name);
+#endif
+
+done:
+    *data = buf;
+    return len;
+}
+
 static int write_server_file(savetype_t autosave)
 {
     cvar_t      *var;
@@ -90,18 +294,16 @@ static int write_server_file(savetype_t autosave)
         return -1;
 
     // write game state
-    size_t json_size = 0;
-    char *game_json = ge->WriteGameJson(autosave == SAVE_LEVEL_START, &json_size);
-    if (!game_json)
-        return -1;
-
-    ret = FS_WriteFile("save/" SAVE_CURRENT "/game.ssv",
-                       game_json, json_size);
-    Z_Free(game_json);
-    if (ret < 0)
+    size_t game_size = 0;
+    void *game_data;
+    if (g_binary_savegames)
+        game_data = g_binary_savegames->WriteGame(autosave == SAVE_LEVEL_START, &game_size);
+    else
+        game_data = ge->WriteGameJson(autosave == SAVE_LEVEL_START, &game_size);
+    if (!game_data)
         return -1;
 
-    return 0;
+    return queue_save_file("save/" SAVE_CURRENT "/game.ssv", game_data, game_size);
 }
 
 static int write_level_file(bool transition)
@@ -154,20 +356,21 @@ static int write_level_file(bool transition)
         return -1;
 
     // write game level
-    size_t json_size = 0;
-    char *level_json = ge->WriteLevelJson(transition, &json_size);
-    if (!level_json)
-        return -1;
-
-    if (Q_snprintf(name, MAX_QPATH, "save/" SAVE_CURRENT "/%s.sav", sv.name) >= MAX_QPATH)
-        ret = -1;
+    size_t level_size = 0;
+    void *level_data;
+    if (g_binary_savegames)
+        level_data = g_binary_savegames->WriteLevel(transition, &level_size);
     else
-        ret = FS_WriteFile(name, level_json, json_size);
-    Z_Free(level_json);
+        level_data = ge->WriteLevelJson(transition, &level_size);
+    if (!level_data)
+        return -1;
 
-    if (ret < 0)
+    if (Q_snprintf(name, MAX_QPATH, "save/" SAVE_CURRENT "/%s.sav", sv.name) >= MAX_QPATH) {
+        Z_Free(level_data);
         return -1;
-    return 0;
+    }
+
+    return queue_save_file(name, level_data, level_size);
 }
 
 static int copy_file(const char *src, const char *dst, const char *name)
@@ -236,6 +439,8 @@ static int wipe_save_dir(const char *dir)
     void **list;
     int i, count, ret = 0;
 
+    flush_save_files();
+
     if ((list = list_save_dir(dir, &count)) == NULL)
         return 0;
 
@@ -251,6 +456,8 @@ static int copy_save_dir(const char *src, const char *dst)
     void **list;
     int i, count, ret = 0;
 
+    flush_save_files();
+
     if ((list = list_save_dir(src, &count)) == NULL)
         return -1;
 
@@ -402,6 +609,7 @@ static int read_server_file(void)
     char        name[MAX_OSPATH], string[MAX_STRING_CHARS];
     mapcmd_t    cmd;
     void        *buf;
+    int         ret;
 
     // errors like missing file, bad version, etc are
     // non-fatal and just return to the command handler
@@ -467,10 +675,13 @@ static int read_server_file(void)
         Com_Error(ERR_DROP, "Game does not support enhanced savegames");
 
     // read game state
-    FS_LoadFile("save/" SAVE_CURRENT "/game.ssv", (void **)&buf);
+    ret = load_save_file("save/" SAVE_CURRENT "/game.ssv", (void **)&buf);
     if (!buf)
         Com_Error(ERR_DROP, "Couldn't read game.ssv");
-    ge->ReadGameJson(buf);
+    if (g_binary_savegames)
+        g_binary_savegames->ReadGame(buf, ret);
+    else
+        ge->ReadGameJson(buf);
     Z_Free(buf);
 
     // clear pending CM
@@ -485,7 +696,7 @@ static int read_level_file(void)
 {
     char    name[MAX_OSPATH];
     size_t  len, maxlen;
-    int     index;
+    int     index, ret;
     void    *data;
 
     if (Q_snprintf(name, MAX_QPATH, "save/" SAVE_CURRENT "/%s.sv2", sv.name) >= MAX_QPATH)
@@ -539,10 +750,13 @@ static int read_level_file(void)
     if (Q_snprintf(name, MAX_OSPATH, "save/" SAVE_CURRENT "/%s.sav", sv.name) >= MAX_OSPATH)
         Com_Error(ERR_DROP, "Savegame path too long");
 
-    FS_LoadFile(name, (void **)&data);
+    ret = load_save_file(name, &data);
     if (!data)
         Com_Error(ERR_DROP, "Couldn't read %s", name);
-    ge->ReadLevelJson(data);
+    if (g_binary_savegames)
+        g_binary_savegames->ReadLevel(data, ret);
+    else
+        ge->ReadLevelJson(data);
     Z_Free(data);
     return 0;
 }
@@ -610,6 +824,12 @@ void SV_AutoSaveEnd(void)
         return;
     }
 
+    // wait for level file queued by SV_AutoSaveBegin and game file
+    if (flush_save_files()) {
+        Com_EPrintf("Couldn't write '%s' directory.\n", SAVE_CURRENT);
+        return;
+    }
+
     // clear whatever savegames are there
     if (wipe_save_dir(SAVE_AUTO)) {
         Com_EPrintf("Couldn't wipe '%s' directory.\n", SAVE_AUTO);
@@ -777,6 +997,11 @@ static void SV_Savegame_f(void)
         return;
     }
 
+    if (flush_save_files()) {
+        Com_Printf("Couldn't write '%s' directory.\n", SAVE_CURRENT);
+        return;
+    }
+
     // clear whatever savegames are there
     if (wipe_save_dir(dir)) {
         Com_Printf("Couldn't wipe '%s' directory.\n", dir);
@@ -18,6 +18,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 // sv_send.c
 
 #include "server.h"
+#include "common/async.h"
 
 /*
 =============================================================================
@@ -838,18 +839,58 @@ static void check_key_sync(const client_t *client)
 }
 #endif
 
+#if USE_MVD_CLIENT
+
+// frames are built in parallel only for MVD spectators: game library
+// callbacks are not thread safe.
+static bool can_build_parallel(void)
+{
+    return sv_parallel_frames->integer && sv.state == ss_broadcast && !g_customize_entity;
+}
+
+static void build_frame_cb(void *arg, int index)
+{
+    client_t **clients = arg;
+    SV_BuildClientFrame(clients[index]);
+}
+
+#else
+
+#define can_build_parallel()    false
+
+#endif
+
+static void write_datagram(client_t *client)
+{
+    if (client->netchan.type == NETCHAN_NEW)
+        write_datagram_new(client);
+    else
+        write_datagram_old(client);
+
+    // advance for next frame
+    client->framenum++;
+
+    // clear all unreliable messages still left
+    finish_frame(client);
+}
+
 /*
 =======================
 SV_SendClientMessages
 
 Called each game frame, sends svc_frame messages to spawned clients only.
 Clients in earlier connection state are handled in SV_SendAsyncPackets.
+
+On MVD relays, client frames can be built on worker threads. Writing and
+transmitting datagrams stays serialized.
 =======================
 */
 void SV_SendClientMessages(void)
 {
     client_t    *client;
-    int         cursize;
+    client_t    *pending[MAX_CLIENTS];
+    int         cursize, i, numpending = 0;
+    bool        parallel = can_build_parallel();
 
     // send a message to each connected client
     FOR_EACH_CLIENT(client) {
@@ -884,13 +925,17 @@ void SV_SendClientMessages(void)
             goto advance;
         }
 
+        // build the new frame later
+        if (parallel) {
+            Q_assert(numpending < q_countof(pending));
+            pending[numpending++] = client;
+            continue;
+        }
+
         // build the new frame and write it
         SV_BuildClientFrame(client);
-
-        if (client->netchan.type == NETCHAN_NEW)
-            write_datagram_new(client);
-        else
-            write_datagram_old(client);
+        write_datagram(client);
+        continue;
 
 advance:
         // advance for next frame
@@ -900,6 +945,16 @@ finish:
         // clear all unreliable messages still left
         finish_frame(client);
     }
+
+    if (!numpending)
+        return;
+
+#if USE_MVD_CLIENT
+    Com_ParallelFor(numpending, build_frame_cb, pending);
+#endif
+
+    for (i = 0; i < numpending; i++)
+        write_datagram(pending[i]);
 }
 
 static void write_pending_download(client_t *client)
@@ -540,6 +540,9 @@ extern cvar_t       *sv_max_download_size;
 extern cvar_t       *sv_max_packet_entities;
 extern cvar_t       *sv_trunc_packet_entities;
 extern cvar_t       *sv_prioritize_entities;
+#if USE_MVD_CLIENT
+extern cvar_t       *sv_parallel_frames;
+#endif
 
 extern cvar_t       *sv_strafejump_hack;
 #if USE_PACKETDUP
@@ -774,6 +777,7 @@ bool SV_WriteFrameToClient_Enhanced(client_t *client, unsigned maxsize);
 extern const game_export_t      *ge;
 extern const game_q2pro_restart_filesystem_t *g_restart_fs;
 extern const game_q2pro_customize_entity_t   *g_customize_entity;
+extern const game_q2pro_binary_savegames_t  *g_binary_savegames;
 
 void SV_InitGameProgs(void);
 void SV_ShutdownGameProgs(void);
@@ -531,8 +531,9 @@ static void SV_ClipMoveToEntities(trace_t *tr,
 {
     vec3_t      boxmins, boxmaxs;
     int         i, num;
-    edict_t     *touchlist[MAX_EDICTS], *touch;
+    edict_t     **touchlist, *touch;
     trace_t     trace;
+    size_t      mark;
 
     // create the bounding box of the entire move
     for (i = 0; i < 3; i++) {
@@ -545,7 +546,9 @@ static void SV_ClipMoveToEntities(trace_t *tr,
         }
     }
 
-    num = SV_AreaEdicts(boxmins, boxmaxs, touchlist, q_countof(touchlist), AREA_SOLID, NULL, NULL);
+    mark = Z_FrameMark();
+    touchlist = Z_FrameAlloc(sizeof(touchlist[0]) * MAX_EDICTS);
+    num = SV_AreaEdicts(boxmins, boxmaxs, touchlist, MAX_EDICTS, AREA_SOLID, NULL, NULL);
 
     // be careful, it is possible to have an entity in this
     // list removed before we get to it (killtriggered)
@@ -554,7 +557,7 @@ static void SV_ClipMoveToEntities(trace_t *tr,
         if (touch->solid == SOLID_NOT)
             continue;
         if (tr->allsolid)
-            return;
+            break;
         if (passedict) {
             if (touch == passedict)
                 continue;
@@ -585,6 +588,8 @@ static void SV_ClipMoveToEntities(trace_t *tr,
 
         CM_ClipEntity(tr, &trace, touch);
     }
+
+    Z_FrameRelease(mark);
 }
 
 /*
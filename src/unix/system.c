@@ -39,7 +39,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include <dlfcn.h>
 #include <errno.h>
 
-#if USE_MEMORY_TRACES && HAVE_BACKTRACE
+#if HAVE_BACKTRACE
 #include <execinfo.h>
 #endif
 
@@ -90,6 +90,49 @@ unsigned Sys_Milliseconds(void)
     return ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL;
 }
 
+uint64_t Sys_Microseconds(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
+}
+
+int Sys_NumCPUs(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+}
+
+int64_t Sys_ReadAt(FILE *fp, void *buf, size_t len, int64_t offset)
+{
+    ssize_t ret;
+
+    do {
+        ret = pread(fileno(fp), buf, len, offset);
+    } while (ret == -1 && errno == EINTR);
+
+    return ret == -1 ? Q_ERRNO : ret;
+}
+
+void *Sys_MapFile(FILE *fp, int64_t size)
+{
+    void *base;
+
+    if (size <= 0 || size > SIZE_MAX)
+        return NULL;
+
+    base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    return base;
+}
+
+void Sys_UnmapFile(void *base, int64_t size)
+{
+    munmap(base, size);
+}
+
 /*
 =================
 Sys_Quit
@@ -313,19 +356,32 @@ void *Sys_GetProcAddress(void *handle, const char *sym)
     return entry;
 }
 
-#if USE_MEMORY_TRACES
 void Sys_BackTrace(void **output, size_t count, size_t offset)
 {
 #if HAVE_BACKTRACE
     int num_entries = backtrace(output, count);
     if (offset > 0) {
         int move_entries = num_entries - min(offset, num_entries);
-        memmove(output, output + offset, move_entries);
+        memmove(output, output + offset, sizeof(void *) * move_entries);
         memset(output + move_entries, 0, sizeof(void *) * (num_entries - move_entries));
     }
 #endif
 }
-#endif
+
+size_t Sys_AddressName(void *addr, char *buf, size_t size)
+{
+    Dl_info info;
+
+    if (!dladdr(addr, &info))
+        return Q_snprintf(buf, size, "%p", addr);
+
+    if (info.dli_sname)
+        return Q_snprintf(buf, size, "%s+%#tx", info.dli_sname,
+                          (byte *)addr - (byte *)info.dli_saddr);
+
+    return Q_snprintf(buf, size, "%s+%#tx", COM_SkipPath(info.dli_fname),
+                      (byte *)addr - (byte *)info.dli_fbase);
+}
 
 
 /*
@@ -33,6 +33,7 @@ with this program; if not, write to the Free Software Foundation, Inc.,
 #include <knownfolders.h>
 #include <shlobj.h>
 #include <versionhelpers.h>
+#include <io.h>
 #endif
 
 HINSTANCE                       hGlobalInstance;
@@ -905,6 +906,68 @@ unsigned Sys_Milliseconds(void)
     return tm.QuadPart * 1000ULL / timer_freq.QuadPart;
 }
 
+uint64_t Sys_Microseconds(void)
+{
+    LARGE_INTEGER tm;
+    QueryPerformanceCounter(&tm);
+    return tm.QuadPart / timer_freq.QuadPart * 1000000ULL +
+           tm.QuadPart % timer_freq.QuadPart * 1000000ULL / timer_freq.QuadPart;
+}
+
+int Sys_NumCPUs(void)
+{
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return max(si.dwNumberOfProcessors, 1);
+}
+
+int64_t Sys_ReadAt(FILE *fp, void *buf, size_t len, int64_t offset)
+{
+    HANDLE h = (HANDLE)_get_osfhandle(_fileno(fp));
+    OVERLAPPED ov = {
+        .Offset = (DWORD)offset,
+        .OffsetHigh = (DWORD)(offset >> 32)
+    };
+    DWORD read;
+
+    if (h == INVALID_HANDLE_VALUE)
+        return Q_ERR(EBADF);
+
+    // this moves file pointer of synchronous handle, but packs are never
+    // read through stdio after they have been loaded
+    if (!ReadFile(h, buf, min(len, INT_MAX), &read, &ov)) {
+        if (GetLastError() == ERROR_HANDLE_EOF)
+            return 0;
+        return Q_ERR_FAILURE;
+    }
+
+    return read;
+}
+
+void *Sys_MapFile(FILE *fp, int64_t size)
+{
+    HANDLE h = (HANDLE)_get_osfhandle(_fileno(fp));
+    HANDLE map;
+    void *base;
+
+    if (h == INVALID_HANDLE_VALUE || size <= 0 || size > SIZE_MAX)
+        return NULL;
+
+    map = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map)
+        return NULL;
+
+    // view keeps mapping object alive
+    base = MapViewOfFile(map, FILE_MAP_READ, 0, 0, size);
+    CloseHandle(map);
+    return base;
+}
+
+void Sys_UnmapFile(void *base, int64_t size)
+{
+    UnmapViewOfFile(base);
+}
+
 void Sys_AddDefaultConfig(void)
 {
 }
@@ -1036,12 +1099,24 @@ void *Sys_GetProcAddress(void *handle, const char *sym)
     return entry;
 }
 
-#if USE_MEMORY_TRACES
 void Sys_BackTrace(void **output, size_t count, size_t offset)
 {
     CaptureStackBackTrace(offset, count, output, NULL);
 }
-#endif
+
+size_t Sys_AddressName(void *addr, char *buf, size_t size)
+{
+    HMODULE module;
+    char path[MAX_PATH];
+
+    if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS |
+                            GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, addr, &module) ||
+        !GetModuleFileNameA(module, path, sizeof(path)))
+        return Q_snprintf(buf, size, "%p", addr);
+
+    return Q_snprintf(buf, size, "%s+%#tx", COM_SkipPath(path),
+                      (byte *)addr - (byte *)module);
+}
 
 /*
 ========================================================================